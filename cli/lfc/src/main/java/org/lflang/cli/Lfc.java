@@ -34,6 +34,8 @@ import org.lflang.target.property.type.LoggingType;
 import org.lflang.target.property.type.LoggingType.LogLevel;
 import org.lflang.target.property.type.SchedulerType;
 import org.lflang.target.property.type.SchedulerType.Scheduler;
+import org.lflang.target.property.type.StatisticsType;
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel;
 import picocli.CommandLine.ArgGroup;
 import picocli.CommandLine.Command;
 import picocli.CommandLine.Option;
@@ -115,9 +117,12 @@ public class Lfc extends CliBase {
 
   @Option(
       names = {"--print-statistics"},
-      arity = "0",
-      description = "Instruct the runtime to collect and print statistics.")
-  private Boolean printStatistics;
+      arity = "0..1",
+      fallbackValue = "true",
+      description =
+          "Instruct the runtime to collect and print statistics. Use 'histograms' to also collect"
+              + " execution time and lag histograms for each reaction.")
+  private String printStatistics;
 
   @Option(
       names = {"-q", "--quiet"},
@@ -292,6 +297,22 @@ public class Lfc extends CliBase {
     return resolved;
   }
 
+  /**
+   * Return a statistics level if one has been specified via the CLI arguments, or {@code null}
+   * otherwise.
+   */
+  private StatisticsLevel getPrintStatistics() {
+    StatisticsLevel resolved = null;
+    if (printStatistics != null) {
+      // Validate statistics level.
+      resolved = new StatisticsType().forName(printStatistics);
+      if (resolved == null) {
+        reporter.printFatalErrorAndExit(printStatistics + ": Invalid statistics level.");
+      }
+    }
+    return resolved;
+  }
+
   /**
    * Return a URI that points to the RTI if one has been specified via the CLI arguments, or {@code
    * null} otherwise.
@@ -379,7 +400,7 @@ public class Lfc extends CliBase {
             new Argument<>(BuildTypeProperty.INSTANCE, getBuildType()),
             new Argument<>(CompilerProperty.INSTANCE, targetCompiler),
             new Argument<>(LoggingProperty.INSTANCE, getLogging()),
-            new Argument<>(PrintStatisticsProperty.INSTANCE, printStatistics),
+            new Argument<>(PrintStatisticsProperty.INSTANCE, getPrintStatistics()),
             new Argument<>(NoCompileProperty.INSTANCE, noCompile),
             new Argument<>(NoSourceMappingProperty.INSTANCE, noSourceMapping),
             new Argument<>(VerifyProperty.INSTANCE, verify),
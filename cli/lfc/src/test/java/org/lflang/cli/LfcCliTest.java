@@ -55,6 +55,7 @@ import org.lflang.target.property.TargetProperty;
 import org.lflang.target.property.type.BuildTypeType.BuildType;
 import org.lflang.target.property.type.LoggingType.LogLevel;
 import org.lflang.target.property.type.SchedulerType.Scheduler;
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel;
 
 /**
  * @author Clément Fournier
@@ -268,7 +269,7 @@ public class LfcCliTest {
               checkOverrideValue(genArgs, CompilerProperty.INSTANCE, "gcc");
               checkOverrideValue(genArgs, LoggingProperty.INSTANCE, LogLevel.INFO);
               checkOverrideValue(genArgs, NoCompileProperty.INSTANCE, true);
-              checkOverrideValue(genArgs, PrintStatisticsProperty.INSTANCE, true);
+              checkOverrideValue(genArgs, PrintStatisticsProperty.INSTANCE, StatisticsLevel.TRUE);
               checkOverrideValue(genArgs, RuntimeVersionProperty.INSTANCE, "rs");
               checkOverrideValue(genArgs, SchedulerProperty.INSTANCE, Scheduler.GEDF_NP);
               checkOverrideValue(genArgs, SingleThreadedProperty.INSTANCE, true);
@@ -343,6 +344,23 @@ public class LfcCliTest {
     verifyGeneratorArgs(tempDir, args);
   }
 
+  @Test
+  public void testPrintStatisticsLevel(@TempDir Path tempDir) throws IOException {
+    TempDirBuilder dir = dirBuilder(tempDir);
+    dir.file("src/File.lf", LF_PYTHON_FILE);
+
+    String[] args = {"src/File.lf", "--no-compile", "--print-statistics", "histograms"};
+    LfcOneShotTestFixture fixture = new LfcOneShotTestFixture();
+    fixture
+        .run(tempDir, args)
+        .verify(
+            result ->
+                checkOverrideValue(
+                    fixture.lfc.getArgs(),
+                    PrintStatisticsProperty.INSTANCE,
+                    StatisticsLevel.HISTOGRAMS));
+  }
+
   @Test
   public void testGeneratorArgsJsonString(@TempDir Path tempDir) throws IOException {
     TempDirBuilder dir = dirBuilder(tempDir);
@@ -38,6 +38,11 @@ public abstract class RuntimeTest extends TestBase {
     return false;
   }
 
+  /** Whether to enable {@link #runBenchmarkTests()}. */
+  protected boolean supportsBenchmarks() {
+    return false;
+  }
+
   /** Whether to enable {@link #runFederatedTests()}. */
   protected boolean supportsFederatedExecution() {
     return false;
@@ -227,6 +232,19 @@ public abstract class RuntimeTest extends TestBase {
         false);
   }
 
+  /** Run benchmark tests if the target supports the benchmark property. */
+  @Test
+  public void runBenchmarkTests() {
+    Assumptions.assumeTrue(supportsBenchmarks(), Message.NO_BENCHMARK_SUPPORT);
+    runTestsForTargets(
+        Message.DESC_BENCHMARK,
+        TestCategory.BENCHMARK::equals,
+        Transformers::noChanges,
+        Configurators::noChanges,
+        TestLevel.EXECUTION,
+        false);
+  }
+
   /** Given a test category, return true if it is compatible with single-threaded execution. */
   public static boolean compatibleWithThreadingOff(TestCategory category) {
 
@@ -289,6 +289,24 @@ public class AttributeUtils {
     return getEnclaveAttribute(node) != null;
   }
 
+  /**
+   * Return the CPUs that the workers of the specified enclave are pinned to, as given by {@code
+   * @enclave(cpus="...")}.
+   *
+   * <p>Returns null if the instance is not an enclave or does not specify CPUs.
+   */
+  public static String getEnclaveCpus(Instantiation node) {
+    return getAttributeParameter(getEnclaveAttribute(node), AttributeSpec.CPUS_ATTR);
+  }
+
+  /**
+   * Return true if the specified bank instance has an {@code @soa} attribute, requesting that the
+   * primitive state variables of all bank members are stored in contiguous arrays.
+   */
+  public static boolean isSoa(Instantiation node) {
+    return findAttributeByName(node, "soa") != null;
+  }
+
   /**
    * Annotate @{code node} with enclave @attribute
    *
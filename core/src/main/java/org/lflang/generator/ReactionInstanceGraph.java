@@ -24,7 +24,9 @@
 
 package org.lflang.generator;
 
+import java.util.ArrayDeque;
 import java.util.ArrayList;
+import java.util.Deque;
 import java.util.LinkedHashSet;
 import java.util.List;
 import java.util.NavigableMap;
@@ -347,7 +349,7 @@ public class ReactionInstanceGraph extends PrecedenceGraph<ReactionInstance.Runt
    * reaction is the least upper bound of the levels of the reactions it depends on.
    */
   private void assignLevels() {
-    List<ReactionInstance.Runtime> start = new ArrayList<>(rootNodes());
+    Deque<ReactionInstance.Runtime> start = new ArrayDeque<>(rootNodes());
 
     // All root nodes start with level 0.
     for (Runtime origin : start) {
@@ -357,7 +359,7 @@ public class ReactionInstanceGraph extends PrecedenceGraph<ReactionInstance.Runt
     // No need to do any of this if there are no root nodes;
     // the graph must be cyclic.
     while (!start.isEmpty()) {
-      Runtime origin = start.remove(0);
+      Runtime origin = start.removeFirst();
       Set<Runtime> toRemove = new LinkedHashSet<>();
       Set<Runtime> downstreamAdjacentNodes = getDownstreamAdjacentNodes(origin);
 
@@ -403,11 +405,11 @@ public class ReactionInstanceGraph extends PrecedenceGraph<ReactionInstance.Runt
    * reverse topologically sorted graph
    */
   private void assignInferredDeadlines() {
-    List<ReactionInstance.Runtime> start = new ArrayList<>(leafNodes());
+    Deque<ReactionInstance.Runtime> start = new ArrayDeque<>(leafNodes());
 
     // All leaf nodes have deadline initialized to their declared deadline or MAX_VALUE
     while (!start.isEmpty()) {
-      Runtime origin = start.remove(0);
+      Runtime origin = start.removeFirst();
       Set<Runtime> toRemove = new LinkedHashSet<>();
       Set<Runtime> upstreamAdjacentNodes = getUpstreamAdjacentNodes(origin);
 
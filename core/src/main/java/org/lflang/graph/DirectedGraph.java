@@ -92,11 +92,24 @@ public class DirectedGraph<T> implements Graph<T> {
   @Override
   public void removeNode(T node) {
     this.graphChanged();
-    this.upstreamAdjacentNodes.remove(node);
-    this.downstreamAdjacentNodes.remove(node);
+    Set<T> upstream = this.upstreamAdjacentNodes.remove(node);
+    Set<T> downstream = this.downstreamAdjacentNodes.remove(node);
     // The node also needs to be removed from the sets that represent connections to the node.
-    CollectionUtil.removeFromValues(this.upstreamAdjacentNodes, node);
-    CollectionUtil.removeFromValues(this.downstreamAdjacentNodes, node);
+    // Since both adjacency maps mirror each other, only the neighbors of the node need to be
+    // visited. This keeps the removal proportional to the degree of the node rather than to the
+    // size of the graph.
+    if (upstream != null) {
+      for (T source : upstream) {
+        this.downstreamAdjacentNodes.computeIfPresent(
+            source, (k, set) -> CollectionUtil.minus(set, node));
+      }
+    }
+    if (downstream != null) {
+      for (T sink : downstream) {
+        this.upstreamAdjacentNodes.computeIfPresent(
+            sink, (k, set) -> CollectionUtil.minus(set, node));
+      }
+    }
   }
 
   /**
@@ -27,6 +27,7 @@ import java.util.Set;
 import net.jcip.annotations.Immutable;
 import org.lflang.lf.TargetDecl;
 import org.lflang.target.property.AuthProperty;
+import org.lflang.target.property.BenchmarkProperty;
 import org.lflang.target.property.BuildCommandsProperty;
 import org.lflang.target.property.BuildTypeProperty;
 import org.lflang.target.property.CargoDependenciesProperty;
@@ -38,19 +39,27 @@ import org.lflang.target.property.CompileDefinitionsProperty;
 import org.lflang.target.property.CompilerProperty;
 import org.lflang.target.property.CoordinationOptionsProperty;
 import org.lflang.target.property.CoordinationProperty;
+import org.lflang.target.property.CpusProperty;
 import org.lflang.target.property.DockerProperty;
 import org.lflang.target.property.ExportDependencyGraphProperty;
 import org.lflang.target.property.ExportToYamlProperty;
 import org.lflang.target.property.ExternalRuntimePathProperty;
 import org.lflang.target.property.FilesProperty;
 import org.lflang.target.property.KeepaliveProperty;
+import org.lflang.target.property.LtoProperty;
+import org.lflang.target.property.MetricsProperty;
 import org.lflang.target.property.NoRuntimeValidationProperty;
 import org.lflang.target.property.NoSourceMappingProperty;
+import org.lflang.target.property.PgoArgumentsProperty;
+import org.lflang.target.property.PgoProperty;
 import org.lflang.target.property.PlatformProperty;
+import org.lflang.target.property.PrecompiledHeadersProperty;
 import org.lflang.target.property.PrintStatisticsProperty;
 import org.lflang.target.property.ProtobufsProperty;
 import org.lflang.target.property.Ros2DependenciesProperty;
+import org.lflang.target.property.Ros2IntraProcessProperty;
 import org.lflang.target.property.Ros2Property;
+import org.lflang.target.property.RuntimeCacheProperty;
 import org.lflang.target.property.RuntimeVersionProperty;
 import org.lflang.target.property.RustIncludeProperty;
 import org.lflang.target.property.SchedulerProperty;
@@ -58,6 +67,7 @@ import org.lflang.target.property.SingleFileProjectProperty;
 import org.lflang.target.property.SingleThreadedProperty;
 import org.lflang.target.property.TracePluginProperty;
 import org.lflang.target.property.TracingProperty;
+import org.lflang.target.property.UnityBuildProperty;
 import org.lflang.target.property.VerifyProperty;
 import org.lflang.target.property.WorkersProperty;
 
@@ -613,18 +623,28 @@ public enum Target {
           VerifyProperty.INSTANCE,
           WorkersProperty.INSTANCE);
       case CPP -> config.register(
+          BenchmarkProperty.INSTANCE,
           BuildTypeProperty.INSTANCE,
           CmakeIncludeProperty.INSTANCE,
           CompilerProperty.INSTANCE,
+          CpusProperty.INSTANCE,
           ExportDependencyGraphProperty.INSTANCE,
           ExportToYamlProperty.INSTANCE,
           ExternalRuntimePathProperty.INSTANCE,
+          LtoProperty.INSTANCE,
+          MetricsProperty.INSTANCE,
           NoRuntimeValidationProperty.INSTANCE,
+          PgoArgumentsProperty.INSTANCE,
+          PgoProperty.INSTANCE,
+          PrecompiledHeadersProperty.INSTANCE,
           PrintStatisticsProperty.INSTANCE,
           Ros2DependenciesProperty.INSTANCE,
+          Ros2IntraProcessProperty.INSTANCE,
           Ros2Property.INSTANCE,
+          RuntimeCacheProperty.INSTANCE,
           RuntimeVersionProperty.INSTANCE,
           TracingProperty.INSTANCE,
+          UnityBuildProperty.INSTANCE,
           WorkersProperty.INSTANCE);
       case Python -> config.register(
           AuthProperty.INSTANCE,
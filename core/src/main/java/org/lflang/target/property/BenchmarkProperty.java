@@ -0,0 +1,46 @@
+package org.lflang.target.property;
+
+import org.lflang.AttributeUtils;
+import org.lflang.MessageReporter;
+import org.lflang.ast.ASTUtils;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+
+/**
+ * If true, additionally build a benchmark executable that runs the program repeatedly and reports
+ * assembly time, startup time, time per tag and reactions per second as JSON. The default is false.
+ */
+public final class BenchmarkProperty extends BooleanProperty {
+
+  /** Singleton target property instance. */
+  public static final BenchmarkProperty INSTANCE = new BenchmarkProperty();
+
+  private BenchmarkProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "benchmark";
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (!config.get(this)) {
+      return;
+    }
+    if (config.get(Ros2Property.INSTANCE)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .warning("The benchmark executable is not built for ROS2 programs.");
+    }
+    // enclaves that share an environment keep it in a static variable, which outlives a single run
+    if (ASTUtils.getAllReactors(config.getMainResource()).stream()
+        .flatMap(reactor -> ASTUtils.allInstantiations(reactor).stream())
+        .anyMatch(AttributeUtils::isEnclave)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .error("The benchmark executable does not support programs with enclaves.");
+    }
+  }
+}
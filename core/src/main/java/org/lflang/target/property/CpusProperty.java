@@ -0,0 +1,74 @@
+package org.lflang.target.property;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Pattern;
+import org.lflang.MessageReporter;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+
+/**
+ * The CPUs that worker threads are pinned to, given as a comma separated list of CPU numbers and
+ * ranges, e.g., "0-3,8". If empty (the default), the operating system places the threads.
+ */
+public final class CpusProperty extends StringProperty {
+
+  /** Singleton target property instance. */
+  public static final CpusProperty INSTANCE = new CpusProperty();
+
+  /** The number of CPUs that fit into a cpu_set_t on Linux. */
+  public static final int MAX_CPUS = 1024;
+
+  private CpusProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "cpus";
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (parseCpuList(config.get(this)) == null) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .error("Expected a comma separated list of CPU numbers and ranges, e.g. \"0-3,8\".");
+    }
+  }
+
+  /** A single CPU number or a range of CPU numbers, optionally surrounded by spaces. */
+  private static final Pattern CPU_ITEM = Pattern.compile(" *([0-9]+) *(?:- *([0-9]+) *)?");
+
+  /**
+   * Parse a list of CPUs such as "0-3,8" into the numbers of all listed CPUs.
+   *
+   * <p>Returns null if the list is malformed. An empty string yields an empty list. This accepts
+   * the same lists as {@code lfutil::affinity::parse_cpu_list} in the C++ runtime support library.
+   */
+  public static List<Integer> parseCpuList(String list) {
+    var cpus = new ArrayList<Integer>();
+    if (list == null || list.chars().allMatch(c -> c == ' ')) {
+      return cpus;
+    }
+    for (var item : list.split(",", -1)) {
+      var matcher = CPU_ITEM.matcher(item);
+      if (!matcher.matches()) {
+        return null;
+      }
+      try {
+        int first = Integer.parseInt(matcher.group(1));
+        int last = matcher.group(2) != null ? Integer.parseInt(matcher.group(2)) : first;
+        if (last < first || last >= MAX_CPUS) {
+          return null;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+          cpus.add(cpu);
+        }
+      } catch (NumberFormatException e) {
+        return null;
+      }
+    }
+    return cpus;
+  }
+}
@@ -0,0 +1,21 @@
+package org.lflang.target.property;
+
+/**
+ * If true, the generated sources and the runtime are compiled with link-time optimization, which
+ * allows the compiler to inline across translation units. This requires CMake 3.9 or newer and a
+ * compiler that supports it. The default is false.
+ */
+public final class LtoProperty extends BooleanProperty {
+
+  /** Singleton target property instance. */
+  public static final LtoProperty INSTANCE = new LtoProperty();
+
+  private LtoProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "lto";
+  }
+}
@@ -0,0 +1,58 @@
+package org.lflang.target.property;
+
+import org.lflang.MessageReporter;
+import org.lflang.ast.ASTUtils;
+import org.lflang.lf.Element;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+import org.lflang.target.property.type.PrimitiveType;
+
+/**
+ * The TCP port on which a running program serves live runtime metrics in the Prometheus text
+ * format. The default is zero, which disables metrics. Metrics are served on the loopback interface
+ * unless another address is given with --metrics-address, or the metrics_address parameter of a
+ * ROS 2 node.
+ */
+public final class MetricsProperty extends TargetProperty<Integer, PrimitiveType> {
+
+  /** Singleton target property instance. */
+  public static final MetricsProperty INSTANCE = new MetricsProperty();
+
+  private MetricsProperty() {
+    super(PrimitiveType.NON_NEGATIVE_INTEGER);
+  }
+
+  @Override
+  public Integer initialValue() {
+    return 0;
+  }
+
+  @Override
+  protected Integer fromString(String string, MessageReporter reporter) {
+    return Integer.parseInt(string);
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (config.get(this) > 65535) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .error("The metrics port must not be greater than 65535.");
+    }
+  }
+
+  @Override
+  protected Integer fromAst(Element node, MessageReporter reporter) {
+    return ASTUtils.toInteger(node);
+  }
+
+  @Override
+  public Element toAstElement(Integer value) {
+    return ASTUtils.toElement(value);
+  }
+
+  @Override
+  public String name() {
+    return "metrics";
+  }
+}
@@ -0,0 +1,22 @@
+package org.lflang.target.property;
+
+/**
+ * Directive for specifying the command-line arguments of the training run of a program that is
+ * built with profile-guided optimization, e.g. to select a representative workload. Arguments are
+ * separated by whitespace. Quotes and escapes are not interpreted, so a single argument cannot
+ * contain whitespace.
+ */
+public final class PgoArgumentsProperty extends StringProperty {
+
+  /** Singleton target property instance. */
+  public static final PgoArgumentsProperty INSTANCE = new PgoArgumentsProperty();
+
+  private PgoArgumentsProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "pgo-arguments";
+  }
+}
@@ -0,0 +1,35 @@
+package org.lflang.target.property;
+
+import org.lflang.MessageReporter;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+
+/**
+ * If true, the program is built with profile-guided optimization. An instrumented binary is built
+ * first and executed as a training run, with the arguments given by {@code pgo-arguments}. The
+ * program is then built again using the recorded profile. This is supported for GCC and Clang. The
+ * default is false.
+ */
+public final class PgoProperty extends BooleanProperty {
+
+  /** Singleton target property instance. */
+  public static final PgoProperty INSTANCE = new PgoProperty();
+
+  private PgoProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "pgo";
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (config.get(this) && config.get(Ros2Property.INSTANCE)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .warning("Profile-guided optimization is not supported for ROS2 programs.");
+    }
+  }
+}
@@ -0,0 +1,21 @@
+package org.lflang.target.property;
+
+/**
+ * If true, the runtime headers are precompiled once for each generated CMake target instead of
+ * being parsed again for each generated source file. This requires CMake 3.16 or newer and is
+ * ignored by older versions. The default is false.
+ */
+public final class PrecompiledHeadersProperty extends BooleanProperty {
+
+  /** Singleton target property instance. */
+  public static final PrecompiledHeadersProperty INSTANCE = new PrecompiledHeadersProperty();
+
+  private PrecompiledHeadersProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "precompiled-headers";
+  }
+}
@@ -1,13 +1,48 @@
 package org.lflang.target.property;
 
-/** If true, instruct the runtime to collect and print execution statistics. */
-public final class PrintStatisticsProperty extends BooleanProperty {
+import org.lflang.MessageReporter;
+import org.lflang.ast.ASTUtils;
+import org.lflang.lf.Element;
+import org.lflang.target.property.type.StatisticsType;
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel;
+
+/**
+ * Instruct the runtime to collect and print execution statistics. If true, aggregate counters are
+ * printed at shutdown. If {@code histograms}, execution time and lag histograms are collected for
+ * each reaction in addition. The default is false.
+ */
+public final class PrintStatisticsProperty
+    extends TargetProperty<StatisticsLevel, StatisticsType> {
 
   /** Singleton target property instance. */
   public static final PrintStatisticsProperty INSTANCE = new PrintStatisticsProperty();
 
   private PrintStatisticsProperty() {
-    super();
+    super(new StatisticsType());
+  }
+
+  @Override
+  public StatisticsLevel initialValue() {
+    return StatisticsLevel.getDefault();
+  }
+
+  @Override
+  protected StatisticsLevel fromAst(Element node, MessageReporter reporter) {
+    return fromString(ASTUtils.elementToSingleString(node), reporter);
+  }
+
+  @Override
+  protected StatisticsLevel fromString(String string, MessageReporter reporter) {
+    return this.type.forName(string);
+  }
+
+  @Override
+  public Element toAstElement(StatisticsLevel value) {
+    return switch (value) {
+      case FALSE -> ASTUtils.toElement(false);
+      case TRUE -> ASTUtils.toElement(true);
+      default -> ASTUtils.toElement(value.toString());
+    };
   }
 
   @Override
@@ -0,0 +1,34 @@
+package org.lflang.target.property;
+
+import org.lflang.MessageReporter;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+
+/**
+ * If true, the generated ROS2 node enables intra-process communication, so that messages published
+ * as {@code std::unique_ptr} are handed to subscriptions in the same process without copying or
+ * serializing them. The default is false.
+ */
+public final class Ros2IntraProcessProperty extends BooleanProperty {
+
+  /** Singleton target property instance. */
+  public static final Ros2IntraProcessProperty INSTANCE = new Ros2IntraProcessProperty();
+
+  private Ros2IntraProcessProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "ros2-intra-process";
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (config.isSet(this) && !config.get(Ros2Property.INSTANCE)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__NAME)
+          .warning("Ignoring ros2-intra-process as ros2 compilation is disabled.");
+    }
+  }
+}
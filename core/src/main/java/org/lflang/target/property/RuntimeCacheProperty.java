@@ -0,0 +1,42 @@
+package org.lflang.target.property;
+
+import org.lflang.MessageReporter;
+import org.lflang.lf.LfPackage.Literals;
+import org.lflang.target.TargetConfig;
+
+/**
+ * Directive for specifying a directory in which prebuilt runtime libraries are shared between
+ * programs. Each runtime is built once per combination of runtime sources, build options and
+ * compiler, installed into a subdirectory of the cache, and found from there by later builds.
+ */
+public final class RuntimeCacheProperty extends StringProperty {
+
+  /** Singleton target property instance. */
+  public static final RuntimeCacheProperty INSTANCE = new RuntimeCacheProperty();
+
+  private RuntimeCacheProperty() {
+    super();
+  }
+
+  @Override
+  public String name() {
+    return "runtime-cache";
+  }
+
+  @Override
+  public void validate(TargetConfig config, MessageReporter reporter) {
+    if (!config.isSet(this)) {
+      return;
+    }
+    if (config.isSet(ExternalRuntimePathProperty.INSTANCE)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .warning("The runtime cache is not used if an external runtime path is given.");
+    }
+    if (config.get(Ros2Property.INSTANCE)) {
+      reporter
+          .at(config.lookup(this), Literals.KEY_VALUE_PAIR__VALUE)
+          .warning("The runtime cache is not used for ROS2 programs.");
+    }
+  }
+}
@@ -0,0 +1,47 @@
+package org.lflang.target.property;
+
+import org.lflang.MessageReporter;
+import org.lflang.ast.ASTUtils;
+import org.lflang.lf.Element;
+import org.lflang.target.property.type.PrimitiveType;
+
+/**
+ * The number of generated source files that are combined into a single translation unit. Combining
+ * sources avoids parsing the same headers repeatedly, but requires that file-local definitions in
+ * the private preambles of different reactors do not clash. This requires CMake 3.16 or newer and
+ * is ignored by older versions. The default is zero, which compiles each source file separately.
+ */
+public final class UnityBuildProperty extends TargetProperty<Integer, PrimitiveType> {
+
+  /** Singleton target property instance. */
+  public static final UnityBuildProperty INSTANCE = new UnityBuildProperty();
+
+  private UnityBuildProperty() {
+    super(PrimitiveType.NON_NEGATIVE_INTEGER);
+  }
+
+  @Override
+  public Integer initialValue() {
+    return 0;
+  }
+
+  @Override
+  protected Integer fromString(String string, MessageReporter reporter) {
+    return Integer.parseInt(string);
+  }
+
+  @Override
+  protected Integer fromAst(Element node, MessageReporter reporter) {
+    return ASTUtils.toInteger(node);
+  }
+
+  @Override
+  public Element toAstElement(Integer value) {
+    return ASTUtils.toElement(value);
+  }
+
+  @Override
+  public String name() {
+    return "unity-build";
+  }
+}
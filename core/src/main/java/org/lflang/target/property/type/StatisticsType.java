@@ -0,0 +1,36 @@
+package org.lflang.target.property.type;
+
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel;
+
+public class StatisticsType extends OptionsType<StatisticsLevel> {
+
+  @Override
+  protected Class<StatisticsLevel> enumClass() {
+    return StatisticsLevel.class;
+  }
+
+  /** Levels of execution statistics that the runtime collects and prints. */
+  public enum StatisticsLevel {
+    /** Do not collect statistics. */
+    FALSE,
+    /** Collect aggregate counters and print them at shutdown. */
+    TRUE,
+    /** Additionally collect execution time and lag histograms for each reaction. */
+    HISTOGRAMS;
+
+    /** Return the name in lower case. */
+    @Override
+    public String toString() {
+      return this.name().toLowerCase();
+    }
+
+    /** Return true if any statistics are collected. */
+    public boolean isEnabled() {
+      return this != FALSE;
+    }
+
+    public static StatisticsLevel getDefault() {
+      return StatisticsLevel.FALSE;
+    }
+  }
+}
@@ -49,6 +49,7 @@ public class AttributeSpec {
 
   public static final String VALUE_ATTR = "value";
   public static final String EACH_ATTR = "each";
+  public static final String CPUS_ATTR = "cpus";
   public static final String OPTION_ATTR = "option";
 
   /** A map from a string to a supported AttributeSpec */
@@ -220,10 +221,15 @@ public class AttributeSpec {
             List.of(
                 new AttrParamSpec(OPTION_ATTR, AttrParamType.STRING, false),
                 new AttrParamSpec(VALUE_ATTR, AttrParamType.STRING, false))));
-    // @enclave(each=boolean)
+    // @enclave(each=boolean, cpus="string")
     ATTRIBUTE_SPECS_BY_NAME.put(
         "enclave",
-        new AttributeSpec(List.of(new AttrParamSpec(EACH_ATTR, AttrParamType.BOOLEAN, true))));
+        new AttributeSpec(
+            List.of(
+                new AttrParamSpec(EACH_ATTR, AttrParamType.BOOLEAN, true),
+                new AttrParamSpec(CPUS_ATTR, AttrParamType.STRING, true))));
+    // @soa
+    ATTRIBUTE_SPECS_BY_NAME.put("soa", new AttributeSpec(null));
     ATTRIBUTE_SPECS_BY_NAME.put("_fed_config", new AttributeSpec(List.of()));
     // @property(name="<property_name>", tactic="<induction|bmc>", spec="<SMTL_spec>")
     // SMTL is the safety fragment of Metric Temporal Logic (MTL).
@@ -116,6 +116,7 @@ import org.lflang.lf.WidthSpec;
 import org.lflang.lf.WidthTerm;
 import org.lflang.target.Target;
 import org.lflang.target.TargetConfig;
+import org.lflang.target.property.CpusProperty;
 import org.lflang.util.FileUtil;
 
 /**
@@ -531,6 +532,44 @@ public class LFValidator extends BaseLFValidator {
         error("Variable-width banks are not supported.", Literals.INSTANTIATION__WIDTH_SPEC);
       }
     }
+    checkSoaInstantiation(instantiation);
+    checkEnclaveCpus(instantiation);
+  }
+
+  /** Check the CPU list given in {@code @enclave(cpus="...")}. */
+  private void checkEnclaveCpus(Instantiation instantiation) {
+    var cpus = AttributeUtils.getEnclaveCpus(instantiation);
+    if (cpus == null) {
+      return;
+    }
+    if (this.target != Target.CPP) {
+      warning(
+          "Pinning enclaves to CPUs is only supported by the C++ target and will be ignored.",
+          Literals.INSTANTIATION__NAME);
+    } else if (CpusProperty.parseCpuList(cpus) == null || cpus.isBlank()) {
+      error(
+          "Expected a comma separated list of CPU numbers and ranges, e.g. \"0-3,8\".",
+          Literals.INSTANTIATION__NAME);
+    }
+  }
+
+  /**
+   * Check that an {@code @soa} annotated instantiation is a bank whose state can be laid out in
+   * bank-wide arrays by the C++ target.
+   */
+  private void checkSoaInstantiation(Instantiation instantiation) {
+    if (!AttributeUtils.isSoa(instantiation)) {
+      return;
+    }
+    if (this.target != Target.CPP) {
+      warning(
+          "The @soa attribute is only supported by the C++ target and will be ignored.",
+          Literals.INSTANTIATION__NAME);
+    } else if (instantiation.getWidthSpec() == null) {
+      error("The @soa attribute can only be applied to banks.", Literals.INSTANTIATION__NAME);
+    } else if (AttributeUtils.isEnclave(instantiation)) {
+      error("The @soa attribute cannot be applied to enclaves.", Literals.INSTANTIATION__NAME);
+    }
   }
 
   @Check(CheckType.FAST)
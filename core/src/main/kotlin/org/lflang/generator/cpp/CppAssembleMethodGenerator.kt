@@ -180,19 +180,20 @@ class CppAssembleMethodGenerator(private val reactor: Reactor) {
         // first left port to determine the type of the entire connection
         val portType = c.leftPorts[0].portType
 
-        // Generate code which adds all left hand ports and all right hand ports to a vector each. If we are handling multiports
-        // within a bank, then we normally iterate over all banks in an outer loop and over all ports in an inner loop. However,
-        // if the connection is an interleaved connection, than we change the order on the right side and iterate over ports before banks.
+        // Generate code which adds all left hand ports to a vector and then passes the right hand ports one by one to
+        // a binder that connects them to the left ports. If we are handling multiports within a bank, then we normally
+        // iterate over all banks in an outer loop and over all ports in an inner loop. However, if the connection is an
+        // interleaved connection, than we change the order and iterate over ports before banks.
         return with(PrependOperator) {
             """
                 |// connection $idx
                 |std::vector<$portType> __lf_left_ports_$idx;
             ${" |"..c.leftPorts.joinWithLn { addAllPortsToVector(it, "__lf_left_ports_$idx") }}
-                |std::vector<$portType> __lf_right_ports_$idx;
-            ${" |"..c.rightPorts.joinWithLn { addAllPortsToVector(it, "__lf_right_ports_$idx") }}
-                |lfutil::bind_multiple_ports<$portType>(__lf_left_ports_$idx, __lf_right_ports_$idx, ${c.isIterated},
+                |lfutil::PortBinder __lf_binder_$idx{__lf_left_ports_$idx, ${c.isIterated},
             ${" |"..c.getConnectionLambda(portType)}
-                |);
+                |};
+            ${" |"..c.rightPorts.joinWithLn { bindAllPorts(it, "__lf_binder_$idx") }}
+                |__lf_binder_$idx.finish();
             """.trimMargin()
         }
     }
@@ -205,6 +206,9 @@ class CppAssembleMethodGenerator(private val reactor: Reactor) {
         """.trimIndent()
     }
 
+    private fun bindAllPorts(varRef: VarRef, binderName: String): String =
+        iterateOverAllPortsAndApply(varRef) { port: String -> "${binderName}.bind(&$port);" }
+
     private fun addAllPortsToVector(varRef: VarRef, vectorName: String): String =
         iterateOverAllPortsAndApply(varRef) { port: String -> "${vectorName}.push_back(&$port);" }
 
@@ -0,0 +1,63 @@
+package org.lflang.generator.cpp
+
+import org.lflang.generator.PortInstance
+import org.lflang.generator.ReactorInstance
+import org.lflang.lf.Input
+import org.lflang.lf.Reactor
+
+/**
+ * Finds the inputs whose values are only read by a single reaction.
+ *
+ * An input is exclusive if, in every instance of its reactor, it is read by exactly one reaction and not forwarded to
+ * contained reactors, and if every value it receives is written by a reaction and sent to no other reader. The reading
+ * reaction may then modify the value in place instead of copying it (see `lfutil::take()`). Values that pass through
+ * delayed or physical connections are conservatively treated as shared.
+ */
+class CppExclusiveInputAnalysis(mainInstance: ReactorInstance) {
+
+    private val exclusive = mutableMapOf<Pair<Reactor, Input>, Boolean>()
+
+    init {
+        if (!mainInstance.hasUnknownWidths()) {
+            analyze(mainInstance)
+        }
+    }
+
+    /** Return the inputs of the given reactor that are exclusive in all instances of the reactor. */
+    fun exclusiveInputs(reactor: Reactor): Set<Input> =
+        exclusive.filter { (key, isExclusive) -> isExclusive && key.first == reactor }.map { it.key.second }.toSet()
+
+    private fun analyze(instance: ReactorInstance) {
+        for (port in instance.inputs) {
+            val key = instance.reactorDefinition to port.definition as Input
+            exclusive[key] = exclusive.getOrDefault(key, true) && port.isExclusive()
+        }
+        instance.children.forEach { analyze(it) }
+    }
+
+    private fun ReactorInstance.hasUnknownWidths(): Boolean =
+        width < 0 || (inputs + outputs).any { it.width < 0 } || children.any { it.hasUnknownWidths() }
+
+    private fun PortInstance.isExclusive(): Boolean {
+        if (isMultiport || dependentReactions.size != 1 || dependentPorts.isNotEmpty()) return false
+        val sources = eventualSources()
+        return sources.isNotEmpty() && sources.all { source ->
+            val sourcePort = source.instance
+            val destinations = sourcePort.eventualDestinations()
+            // each channel of the source is sent to exactly one channel of one port that is read by reactions
+            sourcePort.dependsOnReactions.isNotEmpty() && sourcePort.dependentReactions.isEmpty() &&
+                    !sourcePort.sendsThroughDelayOrPhysical() && destinations.isNotEmpty() &&
+                    destinations.all { it.destinations.size == 1 && it.destinations[0].width == it.width }
+        }
+    }
+
+    /**
+     * Check whether any value of this port is sent through a delayed or physical connection, also via relay ports.
+     *
+     * Such connections are left out by [PortInstance.eventualDestinations], but they still pass on the same value.
+     */
+    private fun PortInstance.sendsThroughDelayOrPhysical(): Boolean = dependentPorts.any { send ->
+        send.connection?.let { it.delay != null || it.isPhysical } == true ||
+                send.destinations.any { it.instance.sendsThroughDelayOrPhysical() }
+    }
+}
@@ -0,0 +1,88 @@
+package org.lflang.generator.cpp
+
+import org.lflang.util.FileUtil
+import java.nio.file.Files
+import java.nio.file.Path
+import java.security.MessageDigest
+
+/**
+ * A persistent cache of content hashes of generated files.
+ *
+ * Generated files are only written if their content changed, so that timestamps of unchanged files are preserved and
+ * the build only recompiles translation units that are affected by a change. The cache remembers hash, size and
+ * modification time of each file written in a previous run. This allows skipping unchanged files without reading them
+ * back from disk. If a file was modified or removed since it was written, the cache entry is ignored and the content
+ * on disk is compared instead.
+ *
+ * The cache is kept per program in its src-gen directory, so that programs of the same package do not evict each
+ * other's entries and can be generated in parallel. Files outside of this directory, like the CMake scripts shared by
+ * all programs of a package, are compared with their content on disk instead of being cached.
+ */
+class CppFileCache(root: Path) {
+
+    companion object {
+        /** Name of the file storing the cache within the root directory */
+        const val cacheFileName = ".lf-hash-cache"
+    }
+
+    private data class Entry(val hash: String, val size: Long, val modified: Long)
+
+    private val root: Path = root.toAbsolutePath().normalize()
+
+    private val cacheFile: Path = this.root.resolve(cacheFileName)
+
+    private val entries: MutableMap<String, Entry> = load()
+
+    /** Keys of all files written in this run */
+    private val written = mutableSetOf<String>()
+
+    private fun load(): MutableMap<String, Entry> {
+        val result = mutableMapOf<String, Entry>()
+        if (!Files.isRegularFile(cacheFile)) return result
+        for (line in Files.readAllLines(cacheFile)) {
+            // each line has the form "<hash> <size> <modified> <path>"
+            val fields = line.split(" ", limit = 4)
+            val size = fields.getOrNull(1)?.toLongOrNull()
+            val modified = fields.getOrNull(2)?.toLongOrNull()
+            if (fields.size == 4 && size != null && modified != null) {
+                result[fields[3]] = Entry(fields[0], size, modified)
+            }
+        }
+        return result
+    }
+
+    private fun hash(bytes: ByteArray): String =
+        MessageDigest.getInstance("SHA-256").digest(bytes).joinToString("") { "%02x".format(it) }
+
+    private fun key(path: Path): String = root.relativize(path.toAbsolutePath().normalize()).toString()
+
+    private fun Entry.matches(path: Path): Boolean =
+        Files.isRegularFile(path) && Files.size(path) == size && Files.getLastModifiedTime(path).toMillis() == modified
+
+    private fun isCached(path: Path): Boolean = path.toAbsolutePath().normalize().startsWith(root)
+
+    /** Write [text] to [path] unless the file already has this content. */
+    fun writeToFile(text: String, path: Path) {
+        if (!isCached(path)) {
+            FileUtil.writeToFile(text, path, true)
+            return
+        }
+        val hash = hash(text.toByteArray())
+        val key = key(path)
+        val entry = entries[key]
+        if (entry == null || entry.hash != hash || !entry.matches(path)) {
+            // compare with the actual file content, in case the cache is outdated
+            FileUtil.writeToFile(text, path, true)
+        }
+        entries[key] = Entry(hash, Files.size(path), Files.getLastModifiedTime(path).toMillis())
+        written.add(key)
+    }
+
+    /** Persist the cache. Entries of files that were not written in this run are dropped. */
+    fun save() {
+        val lines = entries.filterKeys { it in written }
+            .map { (path, entry) -> "${entry.hash} ${entry.size} ${entry.modified} $path" }
+            .sorted()
+        FileUtil.writeToFile(lines.joinToString("\n", postfix = "\n"), cacheFile, true)
+    }
+}
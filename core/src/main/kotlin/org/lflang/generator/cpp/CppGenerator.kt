@@ -31,7 +31,10 @@ import org.lflang.target.Target
 import org.lflang.generator.*
 import org.lflang.generator.GeneratorUtils.canGenerate
 import org.lflang.generator.LFGeneratorContext.Mode
+import org.lflang.AttributeUtils
 import org.lflang.isGeneric
+import org.lflang.reactor
+import org.lflang.toDefinition
 import org.lflang.scoping.LFGlobalScopeProvider
 import org.lflang.target.property.*
 import org.lflang.util.FileUtil
@@ -51,6 +54,9 @@ class CppGenerator(
 
     val fileConfig: CppFileConfig = context.fileConfig as CppFileConfig
 
+    /** Cache for skipping writes of generated files whose content did not change */
+    val fileCache = CppFileCache(fileConfig.srcGenPath)
+
     companion object {
         /** Path to the Cpp lib directory (relative to class path)  */
         const val libDir = "/lib/cpp"
@@ -65,6 +71,9 @@ class CppGenerator(
 
         if (!canGenerate(errorsOccurred(), mainDef, messageReporter, context)) return
 
+        // build the instance graph once and share it between all analyses
+        main = ReactorInstance(mainDef.reactorClass.toDefinition(), messageReporter)
+
         // create a platform-specific generator
         val platformGenerator: CppPlatformGenerator =
             if (targetConfig.get(Ros2Property.INSTANCE)) CppRos2Generator(this) else CppStandaloneGenerator(this)
@@ -74,6 +83,7 @@ class CppGenerator(
 
         // generate platform specific files
         platformGenerator.generatePlatformFiles()
+        fileCache.save()
 
         if (targetConfig.get(NoCompileProperty.INSTANCE) || errorsOccurred()) {
             println("Exiting before invoking target compiler.")
@@ -128,7 +138,7 @@ class CppGenerator(
     private fun generateFiles(srcGenPath: Path, resources: Set<Resource>) {
         // copy static library files over to the src-gen directory
         val genIncludeDir = srcGenPath.resolve("__include__")
-        listOf("lfutil.hh", "time_parser.hh").forEach {
+        listOf("lfutil.hh", "lf_affinity.hh", "lf_benchmark.hh", "lf_config.hh", "lf_ingress.hh", "lf_metrics.hh", "lf_offload.hh", "lf_ros2.hh", "lf_statistics.hh", "lf_trace.hh", "time_parser.hh").forEach {
             FileUtil.copyFileFromClassPath("$libDir/$it", genIncludeDir, true)
         }
         FileUtil.copyFileFromClassPath(
@@ -151,8 +161,23 @@ class CppGenerator(
         }
 
         // generate header and source files for all reactors
+        // reactors that are instantiated as @soa banks store their primitive state in bank-wide arrays
+        val bankStateReactors = reactors.flatMap { it.instantiations }.filter { AttributeUtils.isSoa(it) }
+            .map { it.reactor }.toSet()
+        // if any enclave is pinned to CPUs, its workers need to move there when executing reactions
+        val pinsWorkers = reactors.flatMap { it.instantiations }.any { AttributeUtils.getEnclaveCpus(it) != null }
+        // inputs that are read by a single reaction only can be modified without copying their value
+        val exclusiveInputs = CppExclusiveInputAnalysis(main)
         for (r in reactors) {
-            val generator = CppReactorGenerator(r, fileConfig, messageReporter)
+            val generator = CppReactorGenerator(
+                r,
+                fileConfig,
+                targetConfig,
+                messageReporter,
+                hasBankState = r in bankStateReactors,
+                pinsWorkers = pinsWorkers,
+                exclusiveInputs = exclusiveInputs.exclusiveInputs(r)
+            )
             val headerFile = fileConfig.getReactorHeaderPath(r)
             val sourceFile = if (r.isGeneric) fileConfig.getReactorHeaderImplPath(r) else fileConfig.getReactorSourcePath(r)
             val reactorCodeMap = CodeMap.fromGeneratedCode(generator.generateSource())
@@ -162,8 +187,8 @@ class CppGenerator(
             val headerCodeMap = CodeMap.fromGeneratedCode(generator.generateHeader())
             codeMaps[srcGenPath.resolve(headerFile)] = headerCodeMap
 
-            FileUtil.writeToFile(headerCodeMap.generatedCode, srcGenPath.resolve(headerFile), true)
-            FileUtil.writeToFile(reactorCodeMap.generatedCode, srcGenPath.resolve(sourceFile), true)
+            fileCache.writeToFile(headerCodeMap.generatedCode, srcGenPath.resolve(headerFile))
+            fileCache.writeToFile(reactorCodeMap.generatedCode, srcGenPath.resolve(sourceFile))
         }
 
 
@@ -178,8 +203,8 @@ class CppGenerator(
             val headerCodeMap = CodeMap.fromGeneratedCode(generator.generateHeader())
             codeMaps[srcGenPath.resolve(headerFile)] = headerCodeMap
 
-            FileUtil.writeToFile(headerCodeMap.generatedCode, srcGenPath.resolve(headerFile), true)
-            FileUtil.writeToFile(preambleCodeMap.generatedCode, srcGenPath.resolve(sourceFile), true)
+            fileCache.writeToFile(headerCodeMap.generatedCode, srcGenPath.resolve(headerFile))
+            fileCache.writeToFile(preambleCodeMap.generatedCode, srcGenPath.resolve(sourceFile))
         }
     }
 
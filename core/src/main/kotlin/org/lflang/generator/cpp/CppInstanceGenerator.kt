@@ -28,6 +28,7 @@ import org.lflang.*
 import org.lflang.generator.PrependOperator
 import org.lflang.lf.Instantiation
 import org.lflang.lf.Reactor
+import org.lflang.target.property.CpusProperty
 import org.lflang.validation.AttributeSpec
 
 /** A code generator for reactor instances */
@@ -54,21 +55,36 @@ class CppInstanceGenerator(
             get() = if (isEnclave) enclaveWrapperClassName else reactorType
 
         val Instantiation.enclaveWrapperClassName get() = "EnclaveWrapper_$name"
+
+        /** Whether the members of this bank share a BankState that stores their primitive state variables */
+        val Instantiation.usesBankState: Boolean
+            get() = AttributeUtils.isSoa(this) && CppStateGenerator(reactor, hasBankState = true).usesBankState
+
+        private val Instantiation.bankStateName get() = "__lf_bank_state_$name"
     }
 
-    private fun Instantiation.generateWrapper(): String = """
+    private fun Instantiation.generateWrapper(): String {
+        val cpus = AttributeUtils.getEnclaveCpus(this)?.let { CpusProperty.parseCpuList(it) }
+        val cpusDeclaration =
+            if (cpus != null) "\n|  inline static const lfutil::affinity::CpuList __lf_cpus{${cpus.joinToString(", ")}};" else ""
+        val registerCpus =
+            if (cpus != null) "\n|      lfutil::affinity::Registry::instance().add(__lf_env.get(), __lf_cpus);" else ""
+        // the enclave is constructed on its CPUs, so that its state is allocated close to them
+        val pinConstruction = if (cpus != null) "\n|    lfutil::affinity::ScopedAffinity __lf_affinity{__lf_cpus};" else ""
+        return """
             |struct $enclaveWrapperClassName {
             |  ${if (!hasEachParameter) "inline static " else ""}std::unique_ptr<reactor::Environment> __lf_env{nullptr};
-            |  std::unique_ptr<$reactorType> __lf_instance{nullptr};
+            |  std::unique_ptr<$reactorType> __lf_instance{nullptr};$cpusDeclaration
             |  
             |  $enclaveWrapperClassName(const std::string& name, reactor::Reactor* container, $reactorType::Parameters&& params) {
             |    if (__lf_env == nullptr) {
-            |      __lf_env = std::make_unique<reactor::Environment>(container->fqn() + name, container->environment());
-            |    }
+            |      __lf_env = std::make_unique<reactor::Environment>(container->fqn() + name, container->environment());$registerCpus
+            |    }$pinConstruction
             |    __lf_instance = std::make_unique<$reactorType>(name, __lf_env.get(), std::forward<$reactorType::Parameters>(params));
             |  }
             |};
         """.trimMargin()
+    }
 
     private fun generateDeclaration(inst: Instantiation): String = with(inst) {
         val instance = if (isBank) "std::vector<std::unique_ptr<$cppClass>>" else "std::unique_ptr<$cppClass>"
@@ -80,6 +96,13 @@ class CppInstanceGenerator(
                 """.trimMargin()
             }
         }
+        if (usesBankState) {
+            // the bank state is declared first, so that it is destroyed after the bank members
+            return """
+                |std::unique_ptr<typename $reactorType::BankState> $bankStateName;
+                |$instance $name;
+            """.trimMargin()
+        }
         return "$instance $name;"
     }
 
@@ -114,12 +137,15 @@ class CppInstanceGenerator(
         with(inst) {
             assert(isBank)
             val width = inst.widthSpec.toCppCode()
+            val bankState = if (usesBankState) ", $bankStateName.get(), __lf_idx" else ""
+            val allocateBankState =
+                if (usesBankState) "\n|$bankStateName = std::make_unique<typename $reactorType::BankState>($width);" else ""
             return """
-                |// initialize instance $name
+                |// initialize instance $name$allocateBankState
                 |$name.reserve($width);
+                |static lfutil::IndexedNames __lf_${name}_names{"$name"};
                 |for (size_t __lf_idx = 0; __lf_idx < $width; __lf_idx++) {
-                |  std::string __lf_inst_name = "${name}_" + std::to_string(__lf_idx);
-                |  $name.emplace_back(std::make_unique<$cppClass>(__lf_inst_name, this, ${inst.getParameterStruct()}));
+                |  $name.emplace_back(std::make_unique<$cppClass>(__lf_${name}_names[__lf_idx], this, ${inst.getParameterStruct()}$bankState));
                 |}
             """.trimMargin()
         }
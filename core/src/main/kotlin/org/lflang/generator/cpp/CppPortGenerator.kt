@@ -105,9 +105,9 @@ class CppPortGenerator(private val reactor: Reactor) {
         """
             // initialize port $name
             ${name}.reserve($width);
+            static lfutil::IndexedNames __lf_${name}_names{"$name"};
             for (size_t __lf_idx = 0; __lf_idx < $width; __lf_idx++) {
-              std::string __lf_port_name = "${name}_" + std::to_string(__lf_idx);
-              ${name}.emplace_back(__lf_port_name, this);
+              ${name}.emplace_back(__lf_${name}_names[__lf_idx], this);
             }
         """.trimIndent()
     }
@@ -24,15 +24,19 @@
 
 package org.lflang.generator.cpp
 
+import org.lflang.allConnections
 import org.lflang.generator.PrependOperator
 import org.lflang.generator.cpp.CppInstanceGenerator.Companion.cppClass
 import org.lflang.isBank
+import org.lflang.isMultiport
 import org.lflang.joinWithLn
 import org.lflang.label
 import org.lflang.lf.Action
 import org.lflang.lf.BuiltinTrigger
 import org.lflang.lf.BuiltinTriggerRef
+import org.lflang.lf.Input
 import org.lflang.lf.Instantiation
+import org.lflang.lf.Output
 import org.lflang.lf.Port
 import org.lflang.lf.Reaction
 import org.lflang.lf.Reactor
@@ -40,14 +44,31 @@ import org.lflang.lf.Timer
 import org.lflang.lf.TriggerRef
 import org.lflang.lf.VarRef
 import org.lflang.priority
+import org.lflang.target.TargetConfig
+import org.lflang.target.property.BenchmarkProperty
+import org.lflang.target.property.MetricsProperty
+import org.lflang.target.property.PrintStatisticsProperty
+import org.lflang.target.property.TracingProperty
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel
+import org.lflang.toDefinition
 import org.lflang.toText
 
 /** A C++ code generator for reactions and their function bodies */
 class CppReactionGenerator(
     private val reactor: Reactor,
-    private val portGenerator: CppPortGenerator
+    private val portGenerator: CppPortGenerator,
+    targetConfig: TargetConfig,
+    /** Whether worker threads move to the CPUs of their enclave before executing a reaction */
+    private val pinsWorkers: Boolean = false,
+    /** Inputs that are only read by a single reaction, which may therefore modify their values */
+    private val exclusiveInputs: Set<Input> = emptySet()
 ) {
 
+    private val tracing = targetConfig.get(TracingProperty.INSTANCE).isEnabled
+    private val histograms = targetConfig.get(PrintStatisticsProperty.INSTANCE) == StatisticsLevel.HISTOGRAMS
+    private val benchmark = targetConfig.get(BenchmarkProperty.INSTANCE)
+    private val metrics = targetConfig.get(MetricsProperty.INSTANCE) != 0
+
     private val reactionsWithDeadlines = reactor.reactions.filter { it.deadline != null }
 
     private val VarRef.isContainedRef: Boolean get() = container != null
@@ -69,6 +90,25 @@ class CppReactionGenerator(
 
     private fun Reaction.getViewClassName(container: Instantiation) = "__lf_view_of_${codeName}_on_${container.name}_t"
     private fun Reaction.getViewInstanceName(container: Instantiation) = "__lf_view_of_${codeName}_on_${container.name}"
+    private fun Reaction.getBankViewClassName(container: Instantiation) = "__lf_bank_view_of_${codeName}_on_${container.name}_t"
+
+    /**
+     * Get the ports of a contained bank whose present members are tracked for this reaction.
+     *
+     * These are the scalar outputs read by the reaction. Outputs that are forwarded from further down the hierarchy are
+     * excluded, as they are never set directly.
+     */
+    private fun Reaction.getPresenceTrackedPorts(container: Instantiation): List<Output> {
+        val containerClass = container.reactorClass.toDefinition()
+        return getAllReferencedVariablesForContainer(container)
+            .filterNot { it.isEffectOf(this) }
+            .mapNotNull { it.variable as? Output }
+            .filterNot { port ->
+                port.isMultiport || containerClass.allConnections.any { c ->
+                    c.rightPorts.any { it.container == null && it.variable == port }
+                }
+            }
+    }
 
     private val VarRef.cppType
         get() =
@@ -87,12 +127,19 @@ class CppReactionGenerator(
             else                                                              -> AssertionError("Unexpected trigger type")
         }
 
+    /**
+     * Exclusive inputs are passed by non-const reference. This selects the overload of lfutil::take() that gives
+     * access to the received value without copying it.
+     */
+    private val TriggerRef.constQualifier: String
+        get() = if (this is VarRef && container == null && variable in exclusiveInputs) "" else "const "
+
     private fun Reaction.getBodyParameters(): List<String> =
-        allUncontainedTriggers.map { "[[maybe_unused]] const ${it.cppType}& ${it.name}" } +
-                allUncontainedSources.map { "const ${it.cppType}& ${it.name}" } +
+        allUncontainedTriggers.map { "[[maybe_unused]] ${it.constQualifier}${it.cppType}& ${it.name}" } +
+                allUncontainedSources.map { "${it.constQualifier}${it.cppType}& ${it.name}" } +
                 allUncontainedEffects.map { "${it.cppType}& ${it.name}" } +
                 allReferencedContainers.map {
-                    if (it.isBank) "const std::vector<${getViewClassName(it)}>& ${it.name}"
+                    if (it.isBank) "const ${getBankViewClassName(it)}& ${it.name}"
                     else "${getViewClassName(it)}& ${it.name}"
                 }
 
@@ -102,22 +149,79 @@ class CppReactionGenerator(
                     allUncontainedSources.map { it.name } +
                     allUncontainedEffects.map { it.name } +
                     allReferencedContainers.map { getViewInstanceName(it) }
-            val body = "void ${codeName}_body() { __lf_inner.${codeName}(${parameters.joinToString(", ")}); }"
-            val deadlineHandler =
-                "void ${codeName}_deadline_handler() { __lf_inner.${codeName}_deadline_handler(${parameters.joinToString(", ")}); }"
-
-            return if (deadline == null)
+            val arguments = parameters.joinToString(", ")
+            val body = generateInstrumentedCall("${codeName}_body", "__lf_inner.${codeName}($arguments);", r)
+            val deadlineHandler = generateInstrumentedCall(
+                "${codeName}_deadline_handler",
+                "__lf_inner.${codeName}_deadline_handler($arguments);",
+                r,
+                isDeadlineHandler = true
+            )
+            val statistics =
+                if (histograms) "lfutil::statistics::ReactionStatistics ${r.statisticsName}{fqn() + \".$label\"};\n" else ""
+
+            // the metrics refer to the reaction and thus need to be declared after it
+            val liveMetrics = if (metrics) "\nlfutil::metrics::ReactionMetrics ${r.metricsName}{$codeName};" else ""
+
+            return statistics + if (deadline == null)
                 """
                     $body
                     reactor::Reaction $codeName{"$label", $priority, this, [this]() { ${codeName}_body(); }};
-                """.trimIndent()
+                """.trimIndent() + liveMetrics
             else
                 """
                     $body
                     $deadlineHandler
                     reactor::Reaction $codeName{"$label", $priority, this, [this]() { ${codeName}_body(); }};
-                """.trimIndent()
+                """.trimIndent() + liveMetrics
+        }
+    }
+
+    private val Reaction.statisticsName get() = "__lf_statistics_$codeName"
+
+    private val Reaction.metricsName get() = "__lf_metrics_$codeName"
+
+    /**
+     * Generate a method that calls the given reaction body or deadline handler and records tracing and statistics
+     * events around the call, if enabled. If workers are pinned, the method first moves the executing thread to the
+     * CPUs of the enclave. In benchmark programs, each reaction body is counted. If metrics are enabled, their counters
+     * are updated as well.
+     */
+    private fun generateInstrumentedCall(
+        name: String,
+        call: String,
+        reaction: Reaction,
+        isDeadlineHandler: Boolean = false
+    ): String {
+        val index = reaction.priority - 1
+        val before = mutableListOf<String>()
+        val after = mutableListOf<String>()
+        if (pinsWorkers) before += "lfutil::affinity::pin_worker(environment());"
+        if (isDeadlineHandler) {
+            if (tracing) before += "lfutil::trace::deadline_missed(this, $index);"
+            if (histograms) before += "${reaction.statisticsName}.deadline_missed();"
+            if (metrics) before += "${reaction.metricsName}.deadline_missed();"
+        } else {
+            if (benchmark) before += "lfutil::benchmark::reaction_starts(this);"
+            if (tracing) {
+                before += (reaction.allUncontainedTriggers.filterIsInstance<VarRef>() + reaction.allUncontainedSources)
+                    .filter { it.variable is Input }.distinct()
+                    .map { "lfutil::trace::ports_received(this, $index, ${it.name});" }
+                before += "lfutil::trace::reaction_starts(this, $index);"
+                after += reaction.allUncontainedEffects.filter { it.variable is Port }
+                    .map { "lfutil::trace::ports_sent(this, $index, ${it.name});" }
+            }
+            if (histograms) {
+                before += "auto __lf_start_time = ${reaction.statisticsName}.reaction_starts(this);"
+                after += "${reaction.statisticsName}.reaction_ends(__lf_start_time);"
+            }
+            if (metrics) {
+                before += "auto __lf_metrics_start_time = ${reaction.metricsName}.reaction_starts(this);"
+                after += "${reaction.metricsName}.reaction_ends(__lf_metrics_start_time);"
+            }
+            if (tracing) after += "lfutil::trace::reaction_ends(this, $index);"
         }
+        return (listOf("void $name() {") + before + call + after + "}").joinToString(" ")
     }
 
     private fun generateFunctionDeclaration(reaction: Reaction, postfix: String?): String {
@@ -187,7 +291,7 @@ class CppReactionGenerator(
         val initializers = variables.map { "${it.variable.name}(reactor->${it.variable.name})" }
 
         val viewDeclaration =
-            if (container.isBank) "std::vector<$viewClass> $viewInstance;"
+            if (container.isBank) generateBankViewForContainer(r, container)
             else "$viewClass $viewInstance;"
 
         return with(PrependOperator) {
@@ -198,7 +302,24 @@ class CppReactionGenerator(
             ${" |    "..initializers.joinToString(",\n")}
                 |  {}
                 |};
-                |$viewDeclaration
+            ${" |"..viewDeclaration}
+            """.trimMargin()
+        }
+    }
+
+    /** A bank view is a vector of member views that also keeps track of the present members for each read port. */
+    private fun generateBankViewForContainer(r: Reaction, container: Instantiation): String {
+        val bankViewClass = r.getBankViewClassName(container)
+        val trackedPorts = r.getPresenceTrackedPorts(container)
+        return with(PrependOperator) {
+            """
+                |struct $bankViewClass : public std::vector<${r.getViewClassName(container)}> {
+                |  struct {
+            ${" |    "..trackedPorts.joinWithLn { "lfutil::PresentIndices ${it.name};" }}
+                |  } __lf_present_indices;
+                |  auto present_indices() const -> const decltype(__lf_present_indices)& { return __lf_present_indices; }
+                |};
+                |$bankViewClass ${r.getViewInstanceName(container)};
             """.trimMargin()
         }
     }
@@ -214,12 +335,18 @@ class CppReactionGenerator(
         r.allReferencedContainers.filter { it.isBank }
             .joinWithLn {
                 val viewInstance = r.getViewInstanceName(it)
-                """
-                    $viewInstance.reserve(${it.name}.size());
-                    for (auto& __lf_instance : ${it.name}) {
-                      $viewInstance.emplace_back(__lf_instance.get());
-                    }
-                """.trimIndent()
+                val registrations = r.getPresenceTrackedPorts(it).joinWithLn { port ->
+                    "$viewInstance.__lf_present_indices.${port.name}.register_port(__lf_instance->${port.name});"
+                }
+                with(PrependOperator) {
+                    """
+                        |$viewInstance.reserve(${it.name}.size());
+                        |for (auto& __lf_instance : ${it.name}) {
+                        |  $viewInstance.emplace_back(__lf_instance.get());
+                    ${" |  "..registrations}
+                        |}
+                    """.trimMargin()
+                }
             }
 
     fun generateReactionViews() =
@@ -231,7 +358,11 @@ class CppReactionGenerator(
         }
 
     fun generateReactionViewForwardDeclarations(): String {
-        val classNames = reactor.reactions.map { r -> r.allReferencedContainers.map { r.getViewClassName(it) } }.flatten()
+        val classNames = reactor.reactions.flatMap { r ->
+            r.allReferencedContainers.flatMap {
+                if (it.isBank) listOf(r.getViewClassName(it), r.getBankViewClassName(it)) else listOf(r.getViewClassName(it))
+            }
+        }
         if (classNames.isEmpty()) {
             return ""
         }
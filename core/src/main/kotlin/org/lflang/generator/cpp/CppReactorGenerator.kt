@@ -26,14 +26,30 @@ package org.lflang.generator.cpp
 import org.lflang.MessageReporter
 import org.lflang.generator.PrependOperator
 import org.lflang.isGeneric
+import org.lflang.isLogical
+import org.lflang.lf.Input
 import org.lflang.lf.Reactor
+import org.lflang.target.TargetConfig
+import org.lflang.target.property.BenchmarkProperty
+import org.lflang.target.property.MetricsProperty
+import org.lflang.target.property.PrintStatisticsProperty
+import org.lflang.target.property.TracingProperty
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel
 import org.lflang.toText
 import org.lflang.toUnixString
 
 /**
  * A C++ code generator that produces a C++ class representing a single reactor
  */
-class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfig, messageReporter: MessageReporter) {
+class CppReactorGenerator(
+    private val reactor: Reactor,
+    fileConfig: CppFileConfig,
+    private val targetConfig: TargetConfig,
+    messageReporter: MessageReporter,
+    hasBankState: Boolean = false,
+    private val pinsWorkers: Boolean = false,
+    exclusiveInputs: Set<Input> = emptySet()
+) {
 
     /** Comment to be inserted at the top of generated files */
     private val fileComment = fileComment(reactor.eResource())
@@ -48,13 +64,13 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
     private val preambleHeaderFile = fileConfig.getPreambleHeaderPath(reactor.eResource()).toUnixString()
 
     private val parameters = CppParameterGenerator(reactor)
-    private val state = CppStateGenerator(reactor)
+    private val state = CppStateGenerator(reactor, hasBankState)
     private val methods = CppMethodGenerator(reactor)
     private val instances = CppInstanceGenerator(reactor, fileConfig, messageReporter)
     private val timers = CppTimerGenerator(reactor)
     private val actions = CppActionGenerator(reactor, messageReporter)
     private val ports = CppPortGenerator(reactor)
-    private val reactions = CppReactionGenerator(reactor, ports)
+    private val reactions = CppReactionGenerator(reactor, ports, targetConfig, pinsWorkers, exclusiveInputs)
     private val assemble = CppAssembleMethodGenerator(reactor)
 
     private fun publicPreamble() =
@@ -65,6 +81,22 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
         reactor.preambles.filter { it.isPrivate }
             .joinToString(separator = "\n", prefix = "// private preamble\n") { it.code.toText() }
 
+    private fun optionalIncludes(): String {
+        val includes = mutableListOf<String>()
+        if (targetConfig.get(TracingProperty.INSTANCE).isEnabled) includes += "#include \"lf_trace.hh\""
+        if (targetConfig.get(PrintStatisticsProperty.INSTANCE) == StatisticsLevel.HISTOGRAMS)
+            includes += "#include \"lf_statistics.hh\""
+        if (pinsWorkers) includes += "#include \"lf_affinity.hh\""
+        if (targetConfig.get(BenchmarkProperty.INSTANCE)) includes += "#include \"lf_benchmark.hh\""
+        if (targetConfig.get(MetricsProperty.INSTANCE) != 0) includes += "#include \"lf_metrics.hh\""
+        // physical actions may be fed by an ingress queue, or by calls offloaded from reactions
+        if (reactor.actions.any { !it.isLogical }) {
+            includes += "#include \"lf_ingress.hh\""
+            includes += "#include \"lf_offload.hh\""
+        }
+        return includes.joinToString("\n")
+    }
+
     /** Generate a C++ header file declaring the given reactor. */
     fun generateHeader() = with(PrependOperator) {
         """
@@ -74,6 +106,7 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
             |
             |#include "reactor-cpp/reactor-cpp.hh"
             |#include "lfutil.hh"
+        ${" |"..optionalIncludes()}
             |
             |using namespace std::chrono_literals;
             |
@@ -89,6 +122,7 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
             |  struct Parameters {
         ${" |    "..parameters.generateParameterStructDeclarations()}
             |  };
+        ${" |  "..state.generateBankStateDeclaration()}
             |
             | private:
         ${" |  "..reactions.generateReactionViewForwardDeclarations()}
@@ -102,7 +136,7 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
         ${" |    "..reactions.generateBodyDeclarations()}
         ${" |    "..reactions.generateDeadlineHandlerDeclarations()}
             |
-            |    Inner(reactor::Reactor* reactor, Parameters&& parameters);
+            |    Inner(reactor::Reactor* reactor, Parameters&& parameters${state.generateInnerConstructorParameters()});
             |
             |   friend ${reactor.name};
             |  };
@@ -119,7 +153,7 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
             | public:
         ${" |  "..ports.generateDeclarations()}
         ${" |  "..outerConstructorSignature(true)};
-        ${" |  "..outerConstructorSignature(false)};
+        ${" |  "..outerConstructorSignature(false, withDefaults = true)};
             |
             |  void assemble() override;
             |};
@@ -159,18 +193,22 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
         return with(PrependOperator) {
             """
                 |${reactor.templateLine}
-                |${reactor.templateName}::Inner::Inner(::reactor::Reactor* reactor, Parameters&& parameters)
+                |${reactor.templateName}::Inner::Inner(::reactor::Reactor* reactor, Parameters&& parameters${state.generateInnerConstructorParameters()})
                 |  : LFScope(reactor)
             ${" |  , __lf_parameters(std::forward<Parameters>(parameters))"}
             ${" |  "..state.generateInitializers()}
-                |{}
+                |{
+            ${" |  "..state.generateBankStateAssignments()}
+                |}
                 """.trimMargin()
         }
     }
 
-    private fun outerConstructorSignature(fromEnvironment: Boolean): String {
+    private fun outerConstructorSignature(fromEnvironment: Boolean, withDefaults: Boolean = false): String {
         val containerRef = if (fromEnvironment) "reactor::Environment* __lf_environment" else "reactor::Reactor* __lf_container"
-        return "${reactor.name}(const std::string& name, $containerRef, Parameters&& __lf_parameters)"
+        // only reactors contained in another reactor can be part of a bank
+        val bankState = if (fromEnvironment) "" else state.generateOuterConstructorParameters(withDefaults)
+        return "${reactor.name}(const std::string& name, $containerRef, Parameters&& __lf_parameters$bankState)"
     }
 
     /** Get the constructor definition of the outer reactor class */
@@ -180,7 +218,7 @@ class CppReactorGenerator(private val reactor: Reactor, fileConfig: CppFileConfi
                 |${reactor.templateLine}
                 |${reactor.templateName}::${outerConstructorSignature(fromEnvironment)}
                 |  : reactor::Reactor(name, ${if (fromEnvironment) "__lf_environment" else "__lf_container"})
-                |  , __lf_inner(this, std::forward<Parameters>(__lf_parameters))
+                |  , __lf_inner(this, std::forward<Parameters>(__lf_parameters)${state.generateInnerConstructorArguments(fromEnvironment)})
             ${" |  "..instances.generateInitializers()}
             ${" |  "..timers.generateInitializers()}
             ${" |  "..actions.generateInitializers()}
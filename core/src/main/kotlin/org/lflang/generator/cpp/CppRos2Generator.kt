@@ -1,7 +1,6 @@
 package org.lflang.generator.cpp
 
 import org.lflang.generator.LFGeneratorContext
-import org.lflang.util.FileUtil
 import java.nio.file.Path
 
 /** C++ platform generator for the ROS2 platform.*/
@@ -13,25 +12,22 @@ class CppRos2Generator(generator: CppGenerator) : CppPlatformGenerator(generator
     private val packageGenerator = CppRos2PackageGenerator(generator, nodeGenerator.nodeName)
 
     override fun generatePlatformFiles() {
-        FileUtil.writeToFile(
+        fileCache.writeToFile(
             nodeGenerator.generateHeader(),
-            packagePath.resolve("include").resolve("${nodeGenerator.nodeName}.hh"),
-            true
+            packagePath.resolve("include").resolve("${nodeGenerator.nodeName}.hh")
         )
-        FileUtil.writeToFile(
+        fileCache.writeToFile(
             nodeGenerator.generateSource(),
-            packagePath.resolve("src").resolve("${nodeGenerator.nodeName}.cc"),
-            true
+            packagePath.resolve("src").resolve("${nodeGenerator.nodeName}.cc")
         )
 
-        FileUtil.writeToFile(packageGenerator.generatePackageXml(), packagePath.resolve("package.xml"), true)
-        FileUtil.writeToFile(
+        fileCache.writeToFile(packageGenerator.generatePackageXml(), packagePath.resolve("package.xml"))
+        fileCache.writeToFile(
             packageGenerator.generatePackageCmake(generator.cppSources),
-            packagePath.resolve("CMakeLists.txt"),
-            true
+            packagePath.resolve("CMakeLists.txt")
         )
         val scriptPath = fileConfig.binPath.resolve(fileConfig.name);
-        FileUtil.writeToFile(packageGenerator.generateBinScript(), scriptPath)
+        fileCache.writeToFile(packageGenerator.generateBinScript(), scriptPath)
         scriptPath.toFile().setExecutable(true);
     }
 
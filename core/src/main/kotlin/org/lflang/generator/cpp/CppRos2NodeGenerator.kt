@@ -1,10 +1,17 @@
 package org.lflang.generator.cpp
 
 import org.lflang.target.TargetConfig
+import org.lflang.generator.PrependOperator
 import org.lflang.lf.Reactor
+import org.lflang.target.property.CpusProperty
 import org.lflang.target.property.FastProperty
+import org.lflang.target.property.MetricsProperty
+import org.lflang.target.property.PrintStatisticsProperty
+import org.lflang.target.property.Ros2IntraProcessProperty
 import org.lflang.target.property.TimeOutProperty
+import org.lflang.target.property.TracingProperty
 import org.lflang.target.property.WorkersProperty
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel
 import org.lflang.toUnixString
 
 /** A C++ code generator for creating a ROS2 node from a main reactor definition */
@@ -16,14 +23,23 @@ class CppRos2NodeGenerator(
 
     val nodeName = "${fileConfig.name}Node"
 
-    fun generateHeader(): String {
-        return """
+    private val metricsPort = targetConfig.get(MetricsProperty.INSTANCE)
+
+    private val tracing = targetConfig.get(TracingProperty.INSTANCE).isEnabled
+    private val traceFileName = "${targetConfig.get(TracingProperty.INSTANCE).traceFileName ?: fileConfig.name}.lft"
+
+    private val histograms = targetConfig.get(PrintStatisticsProperty.INSTANCE) == StatisticsLevel.HISTOGRAMS
+
+    fun generateHeader(): String = with(PrependOperator) {
+        """
             |#pragma once
             |
             |#include <rclcpp/rclcpp.hpp>
             |#include "reactor-cpp/reactor-cpp.hh"
             |
             |#include "${fileConfig.getReactorHeaderPath(main).toUnixString()}"
+        ${" |".. if (metricsPort != 0) "#include \"lf_metrics.hh\"" else ""}
+        ${" |".. if (histograms) "#include \"lf_statistics.hh\"" else ""}
             |
             |rclcpp::Node* lf_node{nullptr};
             |
@@ -37,6 +53,8 @@ class CppRos2NodeGenerator(
             |  // an additional thread that we use for waiting for LF termination
             |  // and then shutting down the LF node
             |  std::thread lf_shutdown_thread;
+        ${" |  ".. if (metricsPort != 0) "// serves live metrics while the node is running\nstd::unique_ptr<lfutil::metrics::Server> lf_metrics_server;" else ""}
+        ${" |  ".. if (histograms) "// dumps the statistics whenever the process receives SIGUSR1\nstd::unique_ptr<lfutil::statistics::DumpOnSignal> lf_dump_statistics_on_signal;" else ""}
             |
             |  void wait_for_lf_shutdown();
             |public:
@@ -46,20 +64,70 @@ class CppRos2NodeGenerator(
         """.trimMargin()
     }
 
-    fun generateSource(): String {
-        return """
+    /** Generate the main reactor parameters, which may be loaded from the file given in the ROS parameter `config` */
+    private fun generateParameters(): String {
+        if (main.parameters.isEmpty()) {
+            return "${main.name}::Parameters lf_parameters{};"
+        }
+        return with(PrependOperator) {
+            """
+                |${main.name}::Parameters lf_parameters{};
+                |auto lf_config_file = this->declare_parameter<std::string>("config", "");
+                |if (!lf_config_file.empty()) {
+                |  try {
+                |    lfutil::config::ConfigFile config{lf_config_file};
+            ${" |    "..main.parameters.joinToString("\n") { "config.read(\"${it.name}\", lf_parameters.${it.name});" }}
+                |    config.check_all_used();
+                |  } catch (const lfutil::config::ConfigError& e) {
+                |    // the node cannot be constructed; report the error and let the component container fail loading it
+                |    reactor::log::Error() << e.what();
+                |    throw;
+                |  }
+                |}
+            """.trimMargin()
+        }
+    }
+
+    /**
+     * Generate the options of the node. With intra-process communication, messages published as `std::unique_ptr` are
+     * moved to subscriptions of all nodes in the same component container instead of being serialized.
+     */
+    private fun generateNodeOptions(): String =
+        if (targetConfig.get(Ros2IntraProcessProperty.INSTANCE)) "rclcpp::NodeOptions(node_options).use_intra_process_comms(true)"
+        else "node_options"
+
+    /** Generate the metrics server, which listens on the port and address given by the ROS parameters */
+    private fun generateMetricsServer(): String =
+        """
+            |auto lf_metrics_port = this->declare_parameter<int>("metrics_port", $metricsPort);
+            |auto lf_metrics_address = this->declare_parameter<std::string>("metrics_address", "127.0.0.1");
+            |if (lf_metrics_port < 0 || lf_metrics_port > 65535) {
+            |  // the node cannot be constructed; report the error and let the component container fail loading it
+            |  reactor::log::Error() << "Invalid value for parameter metrics_port: " << lf_metrics_port;
+            |  throw std::invalid_argument("metrics_port must be in the range 0 to 65535");
+            |}
+            |lf_metrics_server = std::make_unique<lfutil::metrics::Server>(static_cast<unsigned>(lf_metrics_port), lf_metrics_address);
+        """.trimMargin()
+
+    fun generateSource(): String = with(PrependOperator) {
+        """
             |#include "$nodeName.hh"
             |#include <rclcpp_components/register_node_macro.hpp>
             |
             |#include <thread>
+            |#include "lf_affinity.hh"
+        ${" |".. if (main.parameters.isNotEmpty()) "#include \"lf_config.hh\"" else ""}
+        ${" |".. if (tracing) "#include \"lf_trace.hh\"" else ""}
             |
             |void $nodeName::wait_for_lf_shutdown() {
             |  lf_main_thread.join();
+        ${" |  ".. if (tracing) "lfutil::trace::stop();" else ""}
+        ${" |  ".. if (histograms) "lfutil::statistics::dump();" else ""}
             |  this->get_node_options().context()->shutdown("LF execution terminated");
             |}
             |
             |$nodeName::$nodeName(const rclcpp::NodeOptions& node_options)
-            |  : Node("$nodeName", node_options) {
+            |  : Node("$nodeName", ${generateNodeOptions()}) {
             |  unsigned workers = ${if (targetConfig.get(WorkersProperty.INSTANCE) != 0) targetConfig.get(WorkersProperty.INSTANCE) else "std::thread::hardware_concurrency()"};
             |  bool fast{${targetConfig.get(FastProperty.INSTANCE)}};
             |  reactor::Duration lf_timeout{${if (targetConfig.isSet(TimeOutProperty.INSTANCE)) targetConfig.get(TimeOutProperty.INSTANCE).toCppCode() else "reactor::Duration::max()"}};
@@ -71,13 +139,30 @@ class CppRos2NodeGenerator(
             |  lf_env = std::make_unique<reactor::Environment>(workers, fast, lf_timeout);
             |
             |  // instantiate the main reactor
-            |  lf_main_reactor = std::make_unique<${main.name}> ("${main.name}", lf_env.get(), ${main.name}::Parameters{});
+        ${" |  "..generateParameters()}
+            |  lf_main_reactor = std::make_unique<${main.name}> ("${main.name}", lf_env.get(), std::move(lf_parameters));
             |
             |  // assemble reactor program
             |  lf_env->assemble();
+        ${" |  ".. if (tracing) "lfutil::trace::start(\"$traceFileName\", lf_main_reactor.get());" else ""}
+        ${" |  ".. if (histograms) "lf_dump_statistics_on_signal = std::make_unique<lfutil::statistics::DumpOnSignal>();" else ""}
+        ${" |  ".. if (metricsPort != 0) generateMetricsServer() else ""}
             |
             |  // start execution
-            |  lf_main_thread = lf_env->startup();
+            |  // worker threads inherit the CPU affinity of the thread that starts them
+            |  auto lf_cpus = this->declare_parameter<std::string>("cpus", "${targetConfig.get(CpusProperty.INSTANCE)}");
+            |  lfutil::affinity::CpuList lf_cpu_list;
+            |  try {
+            |    lf_cpu_list = lfutil::affinity::parse_cpu_list(lf_cpus);
+            |  } catch (const std::invalid_argument& e) {
+            |    // the node cannot be constructed; report the error and let the component container fail loading it
+            |    reactor::log::Error() << "Invalid value for parameter cpus: " << e.what();
+            |    throw;
+            |  }
+            |  {
+            |    lfutil::affinity::ScopedAffinity affinity{lf_cpu_list};
+            |    lf_main_thread = lf_env->startup();
+            |  }
             |  lf_shutdown_thread = std::thread([this] { wait_for_lf_shutdown(); });
             |}
             |
@@ -98,6 +98,7 @@ class CppRos2PackageGenerator(generator: CppGenerator, private val nodeName: Str
                 |else()
                 |  target_compile_options($S{LF_MAIN_TARGET} PRIVATE -Wall -Wextra -pedantic)
                 |endif()
+            ${" |"..CppStandaloneCmakeGenerator.generateBuildAcceleration(targetConfig, "$S{LF_MAIN_TARGET}", "$S{PROJECT_SOURCE_DIR}/src/__include__", listOf())}
                 |
                 |ament_auto_package()
                 |
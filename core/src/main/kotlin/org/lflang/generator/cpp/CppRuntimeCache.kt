@@ -0,0 +1,144 @@
+package org.lflang.generator.cpp
+
+import org.lflang.MessageReporter
+import org.lflang.generator.GeneratorCommandFactory
+import org.lflang.generator.LFGeneratorContext
+import org.lflang.target.TargetConfig
+import org.lflang.target.property.CompilerProperty
+import org.lflang.target.property.LtoProperty
+import org.lflang.target.property.PgoProperty
+import org.lflang.target.property.RuntimeCacheProperty
+import org.lflang.toUnixString
+import java.nio.channels.FileChannel
+import java.nio.file.Files
+import java.nio.file.Path
+import java.nio.file.StandardOpenOption
+import java.security.MessageDigest
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.locks.ReentrantLock
+import kotlin.concurrent.withLock
+
+/**
+ * A directory of prebuilt runtime libraries that is shared between programs.
+ *
+ * Each runtime is installed into a subdirectory named by a hash of everything that affects the build of the runtime:
+ * its sources, the cmake options that configure it, the C++ standard, the compiler and the optimization options.
+ * Programs that agree on all of these link the same installation through `find_package`, so that the runtime is only
+ * compiled once. Concurrent builds of the same runtime, e.g. in parallel CI jobs, are serialized by a lock file in the
+ * cache directory. File locks are held per process, so builds within the same process additionally take a lock per
+ * installation.
+ *
+ * With link-time optimization, the cached runtime is built with interprocedural optimization as well. It is never
+ * instrumented or built with a profile though, since profiles belong to a single program. Profile-guided optimization
+ * therefore only applies to the code of the program when the runtime cache is used.
+ */
+class CppRuntimeCache(
+    private val targetConfig: TargetConfig,
+    fileConfig: CppFileConfig,
+    /** Directory containing the sources of the runtime */
+    private val runtimeSources: Path,
+    /** Arguments of the cmake invocation of the program. Only those configuring the runtime are considered. */
+    cmakeArgs: List<String>,
+) {
+
+    companion object {
+        /** File marking a complete installation within the installation directory */
+        private const val marker = ".lf-runtime-complete"
+
+        /** Locks serializing builds of the same installation within this process */
+        private val locks = ConcurrentHashMap<Path, ReentrantLock>()
+    }
+
+    private val runtimeArgs =
+        cmakeArgs.filter { it.startsWith("-DREACTOR_CPP_") || it.startsWith("-DCMAKE_BUILD_TYPE=") }
+            // the Test build type is only known to the root cmake script of the program
+            .map { if (it == "-DCMAKE_BUILD_TYPE=Test") "-DCMAKE_BUILD_TYPE=Debug" else it }
+            .sorted()
+
+    private val lto = targetConfig.get(LtoProperty.INSTANCE)
+
+    private val pgo = targetConfig.get(PgoProperty.INSTANCE)
+
+    private val buildType = runtimeArgs.firstOrNull { it.startsWith("-DCMAKE_BUILD_TYPE=") }?.substringAfter('=')
+
+    private val compiler = if (targetConfig.isSet(CompilerProperty.INSTANCE)) targetConfig.get(CompilerProperty.INSTANCE)
+    else System.getenv("CXX") ?: ""
+
+    private val root: Path = fileConfig.srcPath.resolve(targetConfig.get(RuntimeCacheProperty.INSTANCE)).normalize()
+
+    /** Directory into which the runtime is installed */
+    val installPath: Path by lazy { root.resolve(key()) }
+
+    private fun key(): String {
+        val digest = MessageDigest.getInstance("SHA-256")
+        Files.walk(runtimeSources).use { paths ->
+            paths.filter { Files.isRegularFile(it) && runtimeSources.relativize(it).none { part -> part.toString() == ".git" } }
+                .map { runtimeSources.relativize(it).toUnixString() }
+                .sorted()
+                .forEach {
+                    digest.update(it.toByteArray())
+                    digest.update(Files.readAllBytes(runtimeSources.resolve(it)))
+                }
+        }
+        (runtimeArgs + "std=${CppGenerator.CPP_VERSION}" + "compiler=$compiler" + "lto=$lto" + "pgo=$pgo").forEach { digest.update(it.toByteArray()) }
+        // 16 bytes are plenty to avoid collisions and keep paths short
+        return digest.digest().take(16).joinToString("") { "%02x".format(it) }
+    }
+
+    /** Build and install the runtime unless it is already in the cache. Return true on success. */
+    fun ensureInstalled(
+        context: LFGeneratorContext,
+        commandFactory: GeneratorCommandFactory,
+        messageReporter: MessageReporter
+    ): Boolean {
+        Files.createDirectories(root)
+        // a second lock on the same file from within this process would fail instead of waiting
+        return locks.computeIfAbsent(installPath) { ReentrantLock() }.withLock {
+            installLocked(context, commandFactory, messageReporter)
+        }
+    }
+
+    private fun installLocked(
+        context: LFGeneratorContext,
+        commandFactory: GeneratorCommandFactory,
+        messageReporter: MessageReporter
+    ): Boolean {
+        FileChannel.open(root.resolve("${installPath.fileName}.lock"), StandardOpenOption.CREATE, StandardOpenOption.WRITE)
+            .use { channel ->
+                channel.lock().use {
+                    if (Files.isRegularFile(installPath.resolve(marker))) {
+                        return true
+                    }
+                    println("Building the runtime into the cache at $installPath")
+                    val buildPath = root.resolve("${installPath.fileName}.build")
+                    Files.createDirectories(buildPath)
+                    val configure = commandFactory.createCommand(
+                        "cmake",
+                        runtimeArgs + listOf(
+                            "-DCMAKE_INSTALL_PREFIX=${installPath.toUnixString()}",
+                            "-DCMAKE_CXX_STANDARD=${CppGenerator.CPP_VERSION}",
+                        ) + (if (lto) listOf(
+                            "-DCMAKE_INTERPROCEDURAL_OPTIMIZATION=ON",
+                            "-DCMAKE_POLICY_DEFAULT_CMP0069=NEW"
+                        ) else listOf()) + runtimeSources.toUnixString(),
+                        buildPath
+                    )
+                    if (compiler.isNotEmpty()) {
+                        configure.setEnvironmentVariable("CXX", compiler)
+                    }
+                    val install = commandFactory.createCommand(
+                        "cmake",
+                        listOf("--build", ".", "--target", "install", "--parallel", Runtime.getRuntime().availableProcessors().toString()) +
+                                (buildType?.let { listOf("--config", it) } ?: listOf()),
+                        buildPath
+                    )
+                    if (configure.run(context.cancelIndicator) != 0 || install.run(context.cancelIndicator) != 0) {
+                        messageReporter.nowhere().error("Failed to build the runtime into the cache at $installPath")
+                        return false
+                    }
+                    Files.writeString(installPath.resolve(marker), runtimeArgs.joinToString("\n", postfix = "\n"))
+                    return true
+                }
+            }
+    }
+}
@@ -31,17 +31,66 @@ import org.lflang.joinWithLn
 import org.lflang.target.property.BuildTypeProperty
 import org.lflang.target.property.CmakeIncludeProperty
 import org.lflang.target.property.ExternalRuntimePathProperty
+import org.lflang.target.property.LtoProperty
+import org.lflang.target.property.PgoProperty
+import org.lflang.target.property.PrecompiledHeadersProperty
 import org.lflang.target.property.RuntimeVersionProperty
+import org.lflang.target.property.UnityBuildProperty
 import org.lflang.toUnixString
 import java.nio.file.Path
 
-/** Code generator for producing a cmake script for compiling all generated C++ sources */
-class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, private val fileConfig: FileConfig) {
+/**
+ * Code generator for producing a cmake script for compiling all generated C++ sources.
+ *
+ * If [cachedRuntimePath] is given, the runtime is not built as part of the project, but found in this installation
+ * directory of the runtime cache.
+ */
+class CppStandaloneCmakeGenerator(
+    private val targetConfig: TargetConfig,
+    private val fileConfig: FileConfig,
+    private val cachedRuntimePath: Path? = null
+) {
 
     companion object {
         /** Return the name of the variable that gives the includes of the given target. */
         fun includesVarName(buildTargetName: String): String = "TARGET_INCLUDE_DIRECTORIES_$buildTargetName"
         const val compilerIdName: String = "CXX_COMPILER_ID"
+
+        /**
+         * Generate cmake code that enables precompiled headers and unity builds for the given target, as far as
+         * requested in the target configuration. Sources in [separateSources] are never combined with other sources.
+         * Both features require CMake 3.16, and older versions simply build without them.
+         */
+        fun generateBuildAcceleration(
+            targetConfig: TargetConfig,
+            target: String,
+            includeDir: String,
+            separateSources: List<String>
+        ): String {
+            val precompiledHeaders = targetConfig.get(PrecompiledHeadersProperty.INSTANCE)
+            val unityBatchSize = targetConfig.get(UnityBuildProperty.INSTANCE)
+            if (!precompiledHeaders && unityBatchSize == 0) {
+                return ""
+            }
+            val commands = mutableListOf<String>()
+            if (precompiledHeaders) {
+                commands += "target_precompile_headers($target PRIVATE <reactor-cpp/reactor-cpp.hh> \"$includeDir/lfutil.hh\")"
+            }
+            if (unityBatchSize > 0) {
+                commands += "set_target_properties($target PROPERTIES UNITY_BUILD ON UNITY_BUILD_BATCH_SIZE $unityBatchSize)"
+                if (separateSources.isNotEmpty()) {
+                    commands += "set_source_files_properties(${separateSources.joinToString(" ")} PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)"
+                }
+            }
+            return with(PrependOperator) {
+                """
+                    |
+                    |if(NOT CMAKE_VERSION VERSION_LESS 3.16)
+                ${" |  "..commands.joinWithLn { it }}
+                    |endif()
+                """.trimMargin()
+            }
+        }
     }
 
     @Suppress("PrivatePropertyName") // allows us to use capital S as variable name below
@@ -102,16 +151,9 @@ class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, privat
             |endif ()
             |
             |set(CMAKE_BUILD_WITH_INSTALL_RPATH ON)
-            |
+            |${generateOptimizationSetup()}
             |file(GLOB subdirs RELATIVE "$S{PROJECT_SOURCE_DIR}" "$S{PROJECT_SOURCE_DIR}/*")
-            |foreach(subdir $S{subdirs})
-            |  if(IS_DIRECTORY "$S{PROJECT_SOURCE_DIR}/$S{subdir}")
-            |    if($S{subdir} MATCHES "reactor-cpp-.*")
-            |      string(SUBSTRING $S{subdir} 12 -1 LF_REACTOR_CPP_SUFFIX)
-            |      add_subdirectory("$S{subdir}")
-            |    endif()
-            |  endif()
-            |endforeach()
+            |${if (cachedRuntimePath == null) generateRuntimeSubdirectories() else generateCachedRuntimeSetup()}
             |foreach(subdir $S{subdirs})
             |  if(IS_DIRECTORY "$S{PROJECT_SOURCE_DIR}/$S{subdir}")
             |    if(EXISTS "$S{PROJECT_SOURCE_DIR}/$S{subdir}/.lf-cpp-marker")
@@ -125,6 +167,92 @@ class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, privat
         }
     }
 
+    /**
+     * Generate cmake code that enables link-time optimization and profile-guided optimization for all targets including
+     * the runtime, as far as requested in the target configuration.
+     *
+     * Profile-guided optimization is controlled by the variable LF_PGO_PHASE, which is passed by the C++ generator for
+     * the two builds. GENERATE builds an instrumented binary that records a profile, and USE builds with the recorded
+     * profile. The phase is removed from the cache again, so a later cmake run without it builds without profiles.
+     */
+    private fun generateOptimizationSetup(): String {
+        val sections = mutableListOf<String>()
+        if (targetConfig.get(LtoProperty.INSTANCE)) {
+            sections += """
+                |# link-time optimization
+                |if(NOT CMAKE_VERSION VERSION_LESS 3.9)
+                |  cmake_policy(SET CMP0069 NEW)
+                |  # also applies to subprojects that require an older cmake version, such as the runtime
+                |  set(CMAKE_POLICY_DEFAULT_CMP0069 NEW)
+                |  include(CheckIPOSupported)
+                |  check_ipo_supported(RESULT LF_IPO_SUPPORTED OUTPUT LF_IPO_OUTPUT)
+                |  if(LF_IPO_SUPPORTED)
+                |    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+                |  else()
+                |    message(WARNING "Link-time optimization is not supported by the compiler: $S{LF_IPO_OUTPUT}")
+                |  endif()
+                |else()
+                |  message(WARNING "Link-time optimization requires CMake 3.9 or newer")
+                |endif()
+            """.trimMargin()
+        }
+        if (targetConfig.get(PgoProperty.INSTANCE)) {
+            sections += """
+                |# profile-guided optimization
+                |# the phase (OFF, GENERATE or USE) only applies to the cmake run it is passed to
+                |set(LF_PGO_PHASE "$S{LF_PGO_PHASE}")
+                |unset(LF_PGO_PHASE CACHE)
+                |if(NOT LF_PGO_PHASE)
+                |  set(LF_PGO_PHASE "OFF")
+                |endif()
+                |set(LF_PGO_DIR "$S{CMAKE_BINARY_DIR}/pgo-profile")
+                |if(NOT LF_PGO_PHASE STREQUAL "OFF")
+                |  if(NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" OR CMAKE_VERSION VERSION_LESS 3.13)
+                |    message(WARNING "Profile-guided optimization requires GCC or Clang and CMake 3.13 or newer")
+                |  elseif(LF_PGO_PHASE STREQUAL "GENERATE")
+                |    add_compile_options(-fprofile-generate=$S{LF_PGO_DIR})
+                |    add_link_options(-fprofile-generate=$S{LF_PGO_DIR})
+                |  elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+                |    # the raw profiles written by clang need to be merged first
+                |    string(REGEX MATCH "^[0-9]+" LF_CLANG_MAJOR_VERSION "$S{CMAKE_CXX_COMPILER_VERSION}")
+                |    find_program(LLVM_PROFDATA NAMES llvm-profdata llvm-profdata-$S{LF_CLANG_MAJOR_VERSION})
+                |    if(NOT LLVM_PROFDATA)
+                |      message(FATAL_ERROR "llvm-profdata is required for profile-guided optimization with clang")
+                |    endif()
+                |    file(GLOB LF_PGO_RAW_PROFILES "$S{LF_PGO_DIR}/*.profraw")
+                |    execute_process(COMMAND $S{LLVM_PROFDATA} merge -o "$S{LF_PGO_DIR}/default.profdata" $S{LF_PGO_RAW_PROFILES})
+                |    add_compile_options(-fprofile-use=$S{LF_PGO_DIR}/default.profdata)
+                |    add_link_options(-fprofile-use=$S{LF_PGO_DIR}/default.profdata)
+                |  else()
+                |    add_compile_options(-fprofile-use=$S{LF_PGO_DIR} -fprofile-correction -Wno-missing-profile)
+                |    add_link_options(-fprofile-use=$S{LF_PGO_DIR})
+                |  endif()
+                |endif()
+            """.trimMargin()
+        }
+        if (sections.isEmpty()) {
+            return ""
+        }
+        return sections.joinToString("\n\n", prefix = "\n", postfix = "\n")
+    }
+
+    private fun generateRuntimeSubdirectories() = """
+        |foreach(subdir $S{subdirs})
+        |  if(IS_DIRECTORY "$S{PROJECT_SOURCE_DIR}/$S{subdir}")
+        |    if($S{subdir} MATCHES "reactor-cpp-.*")
+        |      string(SUBSTRING $S{subdir} 12 -1 LF_REACTOR_CPP_SUFFIX)
+        |      add_subdirectory("$S{subdir}")
+        |    endif()
+        |  endif()
+        |endforeach()
+    """.trimMargin()
+
+    private fun generateCachedRuntimeSetup() = """
+        |# The runtime is prebuilt in the runtime cache. Its library directory is added to the rpath,
+        |# so that the installed binary finds it.
+        |set(CMAKE_INSTALL_RPATH_USE_LINK_PATH ON)
+    """.trimMargin()
+
     fun generateSubdirCmake(): String {
         return """
             |file(GLOB subdirs RELATIVE "$S{CMAKE_CURRENT_SOURCE_DIR}" "$S{CMAKE_CURRENT_SOURCE_DIR}/*")
@@ -138,12 +266,58 @@ class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, privat
         """.trimMargin()
     }
 
-    fun generateCmake(sources: List<Path>): String {
+    /**
+     * Generate the cmake script of the main target. If [benchmarkMain] is given, an additional benchmark executable is
+     * built from the same sources, but with [benchmarkMain] instead of main.cc.
+     */
+    private fun generateBenchmarkTarget(sources: List<Path>, benchmarkMain: Path, reactorCppTarget: String): String {
+        val benchmarkSources = sources.filter { it.fileName.toString() != "main.cc" } + benchmarkMain
+        return with(PrependOperator) {
+            """
+                |
+                |# The benchmark executable runs the program repeatedly and reports measurements as JSON.
+                |# It is not built by default.
+                |add_executable($S{LF_MAIN_TARGET}_benchmark EXCLUDE_FROM_ALL
+            ${" |    "..benchmarkSources.joinWithLn { it.toUnixString() }}
+                |)
+                |target_include_directories($S{LF_MAIN_TARGET}_benchmark PUBLIC
+                |    "$S{LF_SRC_PKG_PATH}/src"
+                |    "$S{PROJECT_SOURCE_DIR}"
+                |    "$S{PROJECT_SOURCE_DIR}/__include__"
+                |)
+                |target_link_libraries($S{LF_MAIN_TARGET}_benchmark $reactorCppTarget)
+                |target_compile_definitions($S{LF_MAIN_TARGET}_benchmark PRIVATE LF_BENCHMARK)
+                |
+                |if(MSVC)
+                |  target_compile_options($S{LF_MAIN_TARGET}_benchmark PRIVATE /W4)
+                |else()
+                |  target_compile_options($S{LF_MAIN_TARGET}_benchmark PRIVATE -Wall -Wextra -pedantic)
+                |endif()
+            ${" |"..generateBuildAcceleration(targetConfig, "$S{LF_MAIN_TARGET}_benchmark", "$S{PROJECT_SOURCE_DIR}/__include__", listOf(benchmarkMain.toUnixString()))}
+                |
+                |install(TARGETS $S{LF_MAIN_TARGET}_benchmark
+                |        RUNTIME DESTINATION $S{CMAKE_INSTALL_BINDIR}
+                |        OPTIONAL
+                |)
+            """.trimMargin()
+        }
+    }
+
+    private fun generateFindRuntime() = when {
+        targetConfig.isSet(ExternalRuntimePathProperty.INSTANCE) ->
+            "find_package(reactor-cpp PATHS ${targetConfig.get(ExternalRuntimePathProperty.INSTANCE)})"
+        cachedRuntimePath != null                                ->
+            "find_package(reactor-cpp REQUIRED PATHS \"${cachedRuntimePath.toUnixString()}\" NO_DEFAULT_PATH)"
+        else                                                     -> ""
+    }
+
+    fun generateCmake(sources: List<Path>, benchmarkMain: Path? = null): String {
         // Resolve path to the cmake include files if any was provided
         val includeFiles = targetConfig.get(CmakeIncludeProperty.INSTANCE)?.map { fileConfig.srcPath.resolve(it).toUnixString() }
 
         val reactorCppTarget = when {
             targetConfig.isSet(ExternalRuntimePathProperty.INSTANCE) -> "reactor-cpp"
+            cachedRuntimePath != null                                -> "reactor-cpp"
             targetConfig.isSet(RuntimeVersionProperty.INSTANCE)      -> "reactor-cpp-${targetConfig.get(RuntimeVersionProperty.INSTANCE)}"
             else                                   -> "reactor-cpp-default"
         }
@@ -153,7 +327,7 @@ class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, privat
                 |cmake_minimum_required(VERSION 3.5)
                 |project(${fileConfig.name} VERSION 0.0.0 LANGUAGES CXX)
                 |
-                |${if (targetConfig.get(ExternalRuntimePathProperty.INSTANCE) != null) "find_package(reactor-cpp PATHS ${targetConfig.get(ExternalRuntimePathProperty.INSTANCE)})" else ""}
+                |${generateFindRuntime()}
                 |
                 |set(LF_MAIN_TARGET ${fileConfig.name})
                 |
@@ -172,11 +346,13 @@ class CppStandaloneCmakeGenerator(private val targetConfig: TargetConfig, privat
                 |else()
                 |  target_compile_options($S{LF_MAIN_TARGET} PRIVATE -Wall -Wextra -pedantic)
                 |endif()
+            ${" |"..generateBuildAcceleration(targetConfig, "$S{LF_MAIN_TARGET}", "$S{PROJECT_SOURCE_DIR}/__include__", listOf("main.cc"))}
                 |
                 |install(TARGETS $S{LF_MAIN_TARGET}
                 |        RUNTIME DESTINATION $S{CMAKE_INSTALL_BINDIR}
                 |        OPTIONAL
                 |)
+            ${" |"..if (benchmarkMain != null) generateBenchmarkTarget(sources, benchmarkMain, reactorCppTarget) else ""}
                 |
                 |# Cache a list of the include directories for use with tools external to CMake and Make.
                 |# This will only work if the subdirectory that sets up the library target has already been visited.
@@ -2,8 +2,14 @@ package org.lflang.generator.cpp
 
 import org.lflang.generator.CodeMap
 import org.lflang.generator.LFGeneratorContext
+import org.lflang.target.property.BenchmarkProperty
 import org.lflang.target.property.BuildTypeProperty
 import org.lflang.target.property.CompilerProperty
+import org.lflang.target.property.ExternalRuntimePathProperty
+import org.lflang.target.property.PgoArgumentsProperty
+import org.lflang.target.property.PgoProperty
+import org.lflang.target.property.RuntimeCacheProperty
+import org.lflang.target.property.RuntimeVersionProperty
 import org.lflang.target.property.type.BuildTypeType.BuildType
 import org.lflang.toUnixString
 import org.lflang.util.FileUtil
@@ -16,6 +22,18 @@ import java.nio.file.Paths
 class CppStandaloneGenerator(generator: CppGenerator) :
     CppPlatformGenerator(generator) {
 
+    /** The shared cache of prebuilt runtimes, if one is used */
+    private val runtimeCache: CppRuntimeCache? by lazy {
+        if (!targetConfig.isSet(RuntimeCacheProperty.INSTANCE) || targetConfig.isSet(ExternalRuntimePathProperty.INSTANCE)) {
+            null
+        } else {
+            val runtimeDir =
+                if (targetConfig.isSet(RuntimeVersionProperty.INSTANCE)) "reactor-cpp-${targetConfig.get(RuntimeVersionProperty.INSTANCE)}"
+                else "reactor-cpp-default"
+            CppRuntimeCache(targetConfig, fileConfig, fileConfig.srcGenBasePath.resolve(runtimeDir), cmakeArgs)
+        }
+    }
+
     override fun generatePlatformFiles() {
 
         // generate the main source file (containing main())
@@ -32,19 +50,34 @@ class CppStandaloneGenerator(generator: CppGenerator) :
         codeMaps[fileConfig.srcGenPath.resolve(mainFile)] = mainCodeMap
         println("Path: $srcGenPath $srcGenPath")
 
-        FileUtil.writeToFile(mainCodeMap.generatedCode, srcGenPath.resolve(mainFile), true)
+        fileCache.writeToFile(mainCodeMap.generatedCode, srcGenPath.resolve(mainFile))
+
+        // generate the main source file of the benchmark executable if requested
+        val benchmarkFile = if (targetConfig.get(BenchmarkProperty.INSTANCE)) Paths.get("benchmark.cc") else null
+        if (benchmarkFile != null) {
+            val benchmarkCodeMap =
+                CodeMap.fromGeneratedCode(
+                    CppStandaloneMainGenerator(
+                        mainReactor,
+                        generator.targetConfig,
+                        generator.fileConfig
+                    ).generateCode(benchmark = true)
+                )
+            codeMaps[fileConfig.srcGenPath.resolve(benchmarkFile)] = benchmarkCodeMap
+            fileCache.writeToFile(benchmarkCodeMap.generatedCode, srcGenPath.resolve(benchmarkFile))
+        }
 
         // generate the cmake scripts
-        val cmakeGenerator = CppStandaloneCmakeGenerator(targetConfig, generator.fileConfig)
+        val cmakeGenerator = CppStandaloneCmakeGenerator(targetConfig, generator.fileConfig, runtimeCache?.installPath)
         val srcGenRoot = fileConfig.srcGenBasePath
         val pkgName = fileConfig.srcGenPkgPath.fileName.toString()
-        FileUtil.writeToFile(cmakeGenerator.generateRootCmake(pkgName), srcGenRoot.resolve("CMakeLists.txt"), true)
-        FileUtil.writeToFile(cmakeGenerator.generateCmake(cppSources), srcGenPath.resolve("CMakeLists.txt"), true)
-        FileUtil.writeToFile("", srcGenPath.resolve(".lf-cpp-marker"), true)
+        fileCache.writeToFile(cmakeGenerator.generateRootCmake(pkgName), srcGenRoot.resolve("CMakeLists.txt"))
+        fileCache.writeToFile(cmakeGenerator.generateCmake(cppSources, benchmarkFile), srcGenPath.resolve("CMakeLists.txt"))
+        fileCache.writeToFile("", srcGenPath.resolve(".lf-cpp-marker"))
         var subdir = srcGenPath.parent
         while (subdir != srcGenRoot) {
-            FileUtil.writeToFile(cmakeGenerator.generateSubdirCmake(), subdir.resolve("CMakeLists.txt"), true)
-            FileUtil.writeToFile("", subdir.resolve(".lf-cpp-marker"), true)
+            fileCache.writeToFile(cmakeGenerator.generateSubdirCmake(), subdir.resolve("CMakeLists.txt"))
+            fileCache.writeToFile("", subdir.resolve(".lf-cpp-marker"))
             subdir = subdir.parent
         }
     }
@@ -62,13 +95,23 @@ class CppStandaloneGenerator(generator: CppGenerator) :
         Files.createDirectories(fileConfig.buildPath)
 
         val version = checkCmakeVersion()
-        if (version != null) {
-            val cmakeReturnCode = runCmake(context)
+        if (version != null && runtimeCache?.ensureInstalled(context, commandFactory, messageReporter) != false) {
+            // with profile-guided optimization, the actual build uses the profile recorded by a training run
+            val pgo = targetConfig.get(PgoProperty.INSTANCE) && runMake
+            if (pgo && !trainProfile(context, version)) {
+                return false
+            }
+            val cmakeReturnCode = runCmake(context, if (pgo) listOf("-DLF_PGO_PHASE=USE") else listOf())
 
             if (cmakeReturnCode == 0 && runMake) {
                 // If cmake succeeded, run make
                 val makeCommand = createMakeCommand(fileConfig.buildPath, version, fileConfig.name)
-                val makeReturnCode = CppValidator(fileConfig, messageReporter, codeMaps).run(makeCommand, context.cancelIndicator)
+                var makeReturnCode = CppValidator(fileConfig, messageReporter, codeMaps).run(makeCommand, context.cancelIndicator)
+                if (makeReturnCode == 0 && targetConfig.get(BenchmarkProperty.INSTANCE)) {
+                    // the benchmark executable is not built by default
+                    val benchmarkCommand = createMakeCommand(fileConfig.buildPath, version, "${fileConfig.name}_benchmark")
+                    makeReturnCode = CppValidator(fileConfig, messageReporter, codeMaps).run(benchmarkCommand, context.cancelIndicator)
+                }
                 var installReturnCode = 0
                 if (makeReturnCode == 0) {
                     val installCommand = createMakeCommand(fileConfig.buildPath, version, "install")
@@ -91,6 +134,44 @@ class CppStandaloneGenerator(generator: CppGenerator) :
         return !messageReporter.errorsOccurred
     }
 
+    /**
+     * Build and install an instrumented binary and execute it to record a profile for profile-guided optimization.
+     * Return true on success.
+     */
+    private fun trainProfile(context: LFGeneratorContext, version: String): Boolean {
+        // profiles of previous builds may no longer match the code
+        FileUtil.deleteDirectory(fileConfig.buildPath.resolve("pgo-profile"))
+
+        println("Building an instrumented binary for profile-guided optimization")
+        if (runCmake(context, listOf("-DLF_PGO_PHASE=GENERATE")) != 0) {
+            messageReporter.nowhere().error("cmake failed while configuring the instrumented build")
+            return false
+        }
+        val makeCommand = createMakeCommand(fileConfig.buildPath, version, fileConfig.name)
+        if (CppValidator(fileConfig, messageReporter, codeMaps).run(makeCommand, context.cancelIndicator) != 0 ||
+            createMakeCommand(fileConfig.buildPath, version, "install").run(context.cancelIndicator) != 0
+        ) {
+            if (!messageReporter.errorsOccurred) {
+                messageReporter.nowhere().error("Failed to build the instrumented binary")
+            }
+            return false
+        }
+
+        println("Executing the training run for profile-guided optimization")
+        // there is no quoting, see PgoArgumentsProperty
+        val arguments = targetConfig.get(PgoArgumentsProperty.INSTANCE).split(Regex("\\s+")).filter { it.isNotEmpty() }
+        val trainingRun = commandFactory.createCommand(
+            fileConfig.binPath.resolve(fileConfig.name).toString(),
+            arguments,
+            fileConfig.binPath
+        )
+        if (trainingRun == null || trainingRun.run(context.cancelIndicator) != 0) {
+            messageReporter.nowhere().error("The training run for profile-guided optimization failed")
+            return false
+        }
+        return true
+    }
+
     private fun checkCmakeVersion(): String? {
         // get the installed cmake version and make sure it is at least 3.5
         val cmd = commandFactory.createCommand("cmake", listOf("--version"), fileConfig.buildPath)
@@ -116,8 +197,8 @@ class CppStandaloneGenerator(generator: CppGenerator) :
      * Run CMake to generate build files.
      * @return True, if cmake run successfully
      */
-    private fun runCmake(context: LFGeneratorContext): Int {
-        val cmakeCommand = createCmakeCommand(fileConfig.buildPath, fileConfig.outPath)
+    private fun runCmake(context: LFGeneratorContext, extraArgs: List<String> = listOf()): Int {
+        val cmakeCommand = createCmakeCommand(fileConfig.buildPath, fileConfig.outPath, extraArgs)
         return cmakeCommand.run(context.cancelIndicator)
     }
 
@@ -160,10 +241,10 @@ class CppStandaloneGenerator(generator: CppGenerator) :
         return commandFactory.createCommand("cmake", makeArgs, buildPath)
     }
 
-    private fun createCmakeCommand(buildPath: Path, outPath: Path): LFCommand {
+    private fun createCmakeCommand(buildPath: Path, outPath: Path, extraArgs: List<String>): LFCommand {
         val cmd = commandFactory.createCommand(
             "cmake",
-            cmakeArgs + listOf(
+            cmakeArgs + extraArgs + listOf(
                 "-DCMAKE_INSTALL_PREFIX=${outPath.toUnixString()}",
                 "-DCMAKE_INSTALL_BINDIR=${outPath.relativize(fileConfig.binPath).toUnixString()}",
                 fileConfig.srcGenBasePath.toUnixString()
@@ -5,11 +5,16 @@ import org.lflang.generator.PrependOperator
 import org.lflang.inferredType
 import org.lflang.lf.Parameter
 import org.lflang.lf.Reactor
+import org.lflang.target.property.CpusProperty
 import org.lflang.target.property.ExportDependencyGraphProperty
 import org.lflang.target.property.ExportToYamlProperty
 import org.lflang.target.property.FastProperty
+import org.lflang.target.property.MetricsProperty
+import org.lflang.target.property.PrintStatisticsProperty
 import org.lflang.target.property.TimeOutProperty
+import org.lflang.target.property.TracingProperty
 import org.lflang.target.property.WorkersProperty
+import org.lflang.target.property.type.StatisticsType.StatisticsLevel
 import org.lflang.toUnixString
 
 /** C++ code generator responsible for generating the main file including the main() function */
@@ -39,10 +44,126 @@ class CppStandaloneMainGenerator(
         }
     }
 
+    private fun generateConfigOption(): String =
+        """
+            options
+                .add_options()("config", "Read parameters of the main reactor from a file. Parameters given on the command line take precedence.", cxxopts::value<std::string>(), "'FILE'");
+        """.trimIndent()
+
+    private fun generateBenchmarkOptions(): String =
+        """
+            unsigned iterations{10};
+            std::string json_file{};
+            options
+                .add_options()
+                  ("iterations", "The number of times the program is executed.", cxxopts::value<unsigned>(iterations)->default_value("10"), "'unsigned'")
+                  ("json", "File that the measurements are written to. They are printed if no file is given.", cxxopts::value<std::string>(json_file)->default_value(""), "'FILE'");
+        """.trimIndent()
+
+    private fun generateConfigRead(param: Parameter): String =
+        """
+            |if (result.count("${param.name}") == 0) {
+            |  config.read("${param.name}", ${param.name});
+            |} else {
+            |  config.ignore("${param.name}");
+            |}
+        """.trimMargin()
+
+    private fun generateConfigLoader(): String = with(PrependOperator) {
+        """
+            |if (result.count("config")) {
+            |  try {
+            |    lfutil::config::ConfigFile config{result["config"].as<std::string>()};
+        ${" |    "..main.parameters.joinToString("\n") { generateConfigRead(it) }}
+            |    config.check_all_used();
+            |  } catch (const lfutil::config::ConfigError& e) {
+            |    reactor::log::Error() << e.what();
+            |    return -1;
+            |  }
+            |}
+        """.trimMargin()
+    }
+
+    private val tracing = targetConfig.get(TracingProperty.INSTANCE).isEnabled
+
+    private val histograms = targetConfig.get(PrintStatisticsProperty.INSTANCE) == StatisticsLevel.HISTOGRAMS
+
+    private val traceFileName = "${targetConfig.get(TracingProperty.INSTANCE).traceFileName ?: fileConfig.name}.lft"
+
+    private val metricsPort = targetConfig.get(MetricsProperty.INSTANCE)
+
     private fun generateMainReactorInstantiation(): String =
             """auto main = std ::make_unique<${main.name}> ("${main.name}", &e, ${main.name}::Parameters{${main.parameters.joinToString(", ") { ".${it.name} = ${it.name}" }}});"""
 
-    fun generateCode() = with(PrependOperator) {
+    /** Generate the statements that construct, assemble and execute the program */
+    private fun generateRun(): String = with(PrependOperator) {
+        """
+            |reactor::Environment e{workers, fast, timeout};
+            |
+            |// instantiate the main reactor
+            |${generateMainReactorInstantiation()}
+            |
+            |// assemble reactor program
+            |e.assemble();
+        ${" |".. if (targetConfig.get(ExportDependencyGraphProperty.INSTANCE)) "e.export_dependency_graph(\"${main.name}.dot\");" else ""}
+        ${" |".. if (targetConfig.get(ExportToYamlProperty.INSTANCE)) "e.dump_to_yaml(\"${main.name}.yaml\");" else ""}
+            |
+        ${" |".. if (tracing) "lfutil::trace::start(\"$traceFileName\", main.get());" else ""}
+        ${" |".. if (histograms) "lfutil::statistics::DumpOnSignal dump_statistics_on_signal{};" else ""}
+        ${" |".. if (metricsPort != 0) "lfutil::metrics::Server metrics_server{metrics_port, metrics_address};" else ""}
+            |
+            |// start execution
+            |std::thread thread{};
+            |{
+            |  // worker threads inherit the CPU affinity of the thread that starts them
+            |  lfutil::affinity::ScopedAffinity affinity{cpu_list};
+            |  thread = e.startup();
+            |}
+            |thread.join();
+        ${" |".. if (tracing) "lfutil::trace::stop();" else ""}
+        ${" |".. if (histograms) "lfutil::statistics::dump();" else ""}
+        """.trimMargin()
+    }
+
+    /**
+     * Generate the statements that construct, assemble and execute the program repeatedly
+     * and report the measurements of all runs.
+     */
+    private fun generateBenchmarkRuns(): String = with(PrependOperator) {
+        """
+            |lfutil::benchmark::Harness harness{"${fileConfig.name}"};
+            |for (unsigned iteration = 0; iteration < iterations; iteration++) {
+            |  harness.begin_run();
+            |  reactor::Environment e{workers, fast, timeout};
+            |  ${generateMainReactorInstantiation()}
+            |  e.assemble();
+            |  harness.assembled();
+            |
+            |  std::thread thread{};
+            |  {
+            |    // worker threads inherit the CPU affinity of the thread that starts them
+            |    lfutil::affinity::ScopedAffinity affinity{cpu_list};
+            |    thread = e.startup();
+            |  }
+            |  thread.join();
+            |  harness.end_run();
+            |}
+            |
+            |if (json_file.empty()) {
+            |  harness.write_json(std::cout);
+            |} else {
+            |  std::ofstream json{json_file};
+            |  harness.write_json(json);
+            |}
+        """.trimMargin()
+    }
+
+    /**
+     * Generate the main file.
+     *
+     * If [benchmark] is true, the generated main() runs the program repeatedly and measures its performance instead.
+     */
+    fun generateCode(benchmark: Boolean = false) = with(PrependOperator) {
         """
         ${" |"..fileComment(main.eResource())}
             |
@@ -58,14 +179,22 @@ class CppStandaloneMainGenerator(
             |
             |#include "${fileConfig.getReactorHeaderPath(main).toUnixString()}"
             |
+            |#include "lf_affinity.hh"
             |#include "time_parser.hh"
+        ${" |".. if (main.parameters.isNotEmpty()) "#include \"lf_config.hh\"" else ""}
+        ${" |".. if (tracing) "#include \"lf_trace.hh\"" else ""}
+        ${" |".. if (histograms) "#include \"lf_statistics.hh\"" else ""}
+        ${" |".. if (benchmark) "#include <fstream>\n#include \"lf_benchmark.hh\"" else ""}
+        ${" |".. if (metricsPort != 0 && !benchmark) "#include \"lf_metrics.hh\"" else ""}
             |
             |int main(int argc, char **argv) {
-            |  cxxopts::Options options("${fileConfig.name}", "Reactor Program");
+            |  cxxopts::Options options("${fileConfig.name}${if (benchmark) "_benchmark" else ""}", "Reactor Program");
             |
             |  unsigned workers = ${if (targetConfig.get(WorkersProperty.INSTANCE) != 0) targetConfig.get(WorkersProperty.INSTANCE) else "std::thread::hardware_concurrency()"};
             |  bool fast{${targetConfig.get(FastProperty.INSTANCE)}};
+            |  std::string cpus{"${targetConfig.get(CpusProperty.INSTANCE)}"};
             |  reactor::Duration timeout = ${if (targetConfig.isSet(TimeOutProperty.INSTANCE)) targetConfig.get(TimeOutProperty.INSTANCE).toCppCode() else "reactor::Duration::max()"};
+        ${" |  ".. if (metricsPort != 0 && !benchmark) "unsigned metrics_port{$metricsPort};\nstd::string metrics_address{\"127.0.0.1\"};" else ""}
             |  
             |  // the timeout variable needs to be tested beyond fitting the Duration-type 
             |  options
@@ -74,9 +203,13 @@ class CppStandaloneMainGenerator(
             |      ("w,workers", "the number of worker threads used by the scheduler", cxxopts::value<unsigned>(workers)->default_value(std::to_string(workers)), "'unsigned'")
             |      ("o,timeout", "Time after which the execution is aborted.", cxxopts::value<reactor::Duration>(timeout)->default_value(time_to_string(timeout)), "'FLOAT UNIT'")
             |      ("f,fast", "Allow logical time to run faster than physical time.", cxxopts::value<bool>(fast)->default_value("${targetConfig.get(FastProperty.INSTANCE)}"))
+            |      ("cpus", "CPUs that the worker threads are pinned to, e.g. 0-3,8. Threads are not pinned if empty.", cxxopts::value<std::string>(cpus)->default_value(cpus), "'LIST'")
+        ${" |      ".. if (metricsPort != 0 && !benchmark) "(\"metrics-port\", \"TCP port on which live metrics are served\", cxxopts::value<unsigned>(metrics_port)->default_value(std::to_string(metrics_port)), \"'unsigned'\")\n(\"metrics-address\", \"IPv4 address on which live metrics are served, e.g. 0.0.0.0 for all interfaces\", cxxopts::value<std::string>(metrics_address)->default_value(metrics_address), \"'ADDRESS'\")" else ""}
             |      ("help", "Print help");
+        ${" |".. if (benchmark) generateBenchmarkOptions() else ""}
             |      
         ${" |"..main.parameters.joinToString("\n\n") { generateParameterParser(it) }}
+        ${" |".. if (main.parameters.isNotEmpty()) generateConfigOption() else ""}
             |
             |  cxxopts::ParseResult result{};
             |  bool parse_error{false};
@@ -94,19 +227,17 @@ class CppStandaloneMainGenerator(
             |       return parse_error ? -1 : 0;
             |  }
             |
-            |  reactor::Environment e{workers, fast, timeout};
-            |
-            |  // instantiate the main reactor
-            |  ${generateMainReactorInstantiation()}
+        ${" |  ".. if (main.parameters.isNotEmpty()) generateConfigLoader() else ""}
             |
-            |  // assemble reactor program
-            |  e.assemble();
-        ${" |".. if (targetConfig.get(ExportDependencyGraphProperty.INSTANCE)) "e.export_dependency_graph(\"${main.name}.dot\");" else ""}
-        ${" |".. if (targetConfig.get(ExportToYamlProperty.INSTANCE)) "e.dump_to_yaml(\"${main.name}.yaml\");" else ""}
+            |  lfutil::affinity::CpuList cpu_list{};
+            |  try {
+            |    cpu_list = lfutil::affinity::parse_cpu_list(cpus);
+            |  } catch (const std::invalid_argument& e) {
+            |    reactor::log::Error() << "Invalid value for --cpus: " << e.what();
+            |    return -1;
+            |  }
             |
-            |  // start execution
-            |  auto thread = e.startup();
-            |  thread.join();
+        ${" |  "..if (benchmark) generateBenchmarkRuns() else generateRun()}
             |  return 0;
             |}
         """.trimMargin()
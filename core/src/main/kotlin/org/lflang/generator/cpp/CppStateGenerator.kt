@@ -24,24 +24,107 @@
 
 package org.lflang.generator.cpp
 
+import org.lflang.generator.PrependOperator
 import org.lflang.inferredType
 import org.lflang.isInitialized
 import org.lflang.joinWithLn
 import org.lflang.lf.Reactor
+import org.lflang.lf.StateVar
 
-/** A C++ code generator for state variables */
-class CppStateGenerator(private val reactor: Reactor) {
+/**
+ * A C++ code generator for state variables
+ *
+ * If [hasBankState] is true, the reactor is instantiated as an `@soa` bank somewhere in the program. In this case,
+ * primitive state variables are stored in a `BankState` struct that holds one array per state variable, and the
+ * reactor only holds references into these arrays. Reactors that are not part of an `@soa` bank allocate their own
+ * `BankState` of size one.
+ */
+class CppStateGenerator(private val reactor: Reactor, private val hasBankState: Boolean = false) {
+
+    companion object {
+        /** Types that can be stored in bank-wide arrays. bool is excluded as std::vector<bool> does not store bools. */
+        private val primitiveTypes = setOf(
+            "char", "signed char", "unsigned char", "short", "unsigned short", "int", "unsigned", "unsigned int",
+            "long", "unsigned long", "long long", "unsigned long long", "float", "double", "long double",
+            "size_t", "std::size_t", "reactor::Duration"
+        ) + listOf("int", "uint").flatMap { prefix ->
+            listOf(8, 16, 32, 64).flatMap { bits -> listOf("${prefix}${bits}_t", "std::${prefix}${bits}_t") }
+        }
+    }
+
+    private val StateVar.isPrimitive: Boolean get() = inferredType.cppType in primitiveTypes
+
+    private val bankStateVars: List<StateVar> = if (hasBankState) reactor.stateVars.filter { it.isPrimitive } else listOf()
+
+    /** Whether the reactor stores any of its state variables in a BankState struct */
+    val usesBankState: Boolean get() = bankStateVars.isNotEmpty()
+
+    /** Get the declaration of the BankState struct */
+    fun generateBankStateDeclaration(): String {
+        if (!usesBankState) return ""
+        return with(PrependOperator) {
+            """
+                |// storage for the primitive state variables of all members of an @soa bank
+                |struct BankState {
+            ${" |  "..bankStateVars.joinWithLn { "std::vector<${it.inferredType.cppType}> ${it.name};" }}
+                |
+                |  explicit BankState(std::size_t width)
+                |    : ${bankStateVars.joinToString(", ") { "${it.name}(width)" }} {}
+                |};
+            """.trimMargin()
+        }
+    }
 
     /** Get all state declarations */
-    fun generateDeclarations() =
-        reactor.stateVars.joinToString("\n", "// state variable\n", "\n") {
-            "${it.inferredType.cppType} ${it.name};"
+    fun generateDeclarations(): String {
+        val bankState = if (!usesBankState) "" else """
+            |// bank state
+            |std::unique_ptr<BankState> __lf_own_bank_state;
+            |BankState& __lf_bank_state;
+            |const std::size_t __lf_bank_state_idx;
+            |
+        """.trimMargin()
+        return bankState + reactor.stateVars.joinToString("\n", "// state variable\n", "\n") {
+            if (it in bankStateVars) "${it.inferredType.cppType}& ${it.name};"
+            else "${it.inferredType.cppType} ${it.name};"
         }
+    }
 
     /** Get all state initializers */
-    fun generateInitializers(): String =
-        reactor.stateVars.filter { it.isInitialized }
+    fun generateInitializers(): String {
+        val bankState = if (!usesBankState) "" else """
+            |// bank state
+            |, __lf_own_bank_state(bank_state == nullptr ? std::make_unique<BankState>(1) : nullptr)
+            |, __lf_bank_state(bank_state == nullptr ? *__lf_own_bank_state : *bank_state)
+            |, __lf_bank_state_idx(bank_state == nullptr ? 0 : bank_state_idx)
+            |
+        """.trimMargin()
+        return bankState + reactor.stateVars.filter { it.isInitialized || it in bankStateVars }
             .joinWithLn(prefix = "// state variables\n") {
-                ", " + it.name + CppTypes.getCppInitializer(it.init, it.inferredType, disableEquals = true)
+                if (it in bankStateVars) ", ${it.name}(__lf_bank_state.${it.name}[__lf_bank_state_idx])"
+                else ", " + it.name + CppTypes.getCppInitializer(it.init, it.inferredType, disableEquals = true)
             }
+    }
+
+    /** Get the assignments of initial values to state variables that are stored in the bank state */
+    fun generateBankStateAssignments(): String =
+        bankStateVars.filter { it.isInitialized }.joinWithLn {
+            "${it.name} = ${it.inferredType.cppType}${CppTypes.getCppInitializer(it.init, it.inferredType, disableEquals = true)};"
+        }
+
+    /** Get the parameters that need to be added to the inner constructor */
+    fun generateInnerConstructorParameters(): String =
+        if (!usesBankState) "" else ", BankState* bank_state, std::size_t bank_state_idx"
+
+    /** Get the parameters that need to be added to the outer constructor */
+    fun generateOuterConstructorParameters(withDefaults: Boolean): String =
+        if (!usesBankState) ""
+        else if (withDefaults) ", BankState* __lf_bank_state = nullptr, std::size_t __lf_bank_state_idx = 0"
+        else ", BankState* __lf_bank_state, std::size_t __lf_bank_state_idx"
+
+    /** Get the arguments passed from the outer constructor to the inner constructor */
+    fun generateInnerConstructorArguments(fromEnvironment: Boolean): String =
+        if (!usesBankState) ""
+        else if (fromEnvironment) ", nullptr, 0"
+        else ", __lf_bank_state, __lf_bank_state_idx"
 }
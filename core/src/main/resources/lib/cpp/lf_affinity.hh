@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Pinning of worker threads to CPUs for the C++ target.
+ *
+ * Threads inherit the CPU affinity of the thread that creates them. The generated main() therefore
+ * pins itself to the CPUs given by the cpus target property or the --cpus option while it starts the
+ * runtime, which places all worker threads on these CPUs. Workers of enclaves that are annotated
+ * with @enclave(cpus="...") move to the CPUs of their enclave when they execute its first reaction.
+ *
+ * Pinning is only implemented on Linux. On other platforms, the CPUs are ignored.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::affinity {
+
+/// Maximum number of CPUs that can be given in a CPU list
+constexpr unsigned max_cpus = 1024;
+
+using CpuList = std::vector<unsigned>;
+
+/**
+ * Parse a comma separated list of CPU numbers and ranges such as "0-3,8".
+ *
+ * An empty string yields an empty list. Throws std::invalid_argument if the list is malformed.
+ * This must accept the same lists as CpusProperty.parseCpuList, which validates the cpus target
+ * property; test/Cpp/src/target/CpuList.lf holds the cases that both are checked against.
+ */
+inline auto parse_cpu_list(std::string_view list) -> CpuList {
+  CpuList cpus{};
+  auto parse_number = [](std::string_view text) {
+    unsigned value{0};
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (text.empty() || ec != std::errc{} || ptr != text.data() + text.size() || value >= max_cpus) {
+      throw std::invalid_argument("not a valid CPU number: " + std::string{text});
+    }
+    return value;
+  };
+  auto trim = [](std::string_view text) {
+    while (!text.empty() && text.front() == ' ') {
+      text.remove_prefix(1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+      text.remove_suffix(1);
+    }
+    return text;
+  };
+  if (trim(list).empty()) {
+    return cpus;
+  }
+  while (true) {
+    auto comma = list.find(',');
+    auto item = list.substr(0, comma);
+    auto dash = item.find('-');
+    auto first = parse_number(trim(item.substr(0, dash)));
+    auto last = dash == std::string_view::npos ? first : parse_number(trim(item.substr(dash + 1)));
+    if (last < first) {
+      throw std::invalid_argument("not a valid CPU range: " + std::string{item});
+    }
+    for (auto cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    list.remove_prefix(comma + 1);
+  }
+  return cpus;
+}
+
+#if defined(__linux__)
+inline void set_thread_affinity(const cpu_set_t& set) {
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    reactor::log::Warn() << "Could not pin thread to the requested CPUs";
+  }
+}
+#endif
+
+/// Pin the calling thread to the given CPUs. Does nothing if the list is empty.
+inline void pin_current_thread(const CpuList& cpus) {
+#if defined(__linux__)
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  set_thread_affinity(set);
+#else
+  (void)cpus;
+#endif
+}
+
+/**
+ * Pins the calling thread to the given CPUs for the lifetime of this object.
+ *
+ * Threads created during this time inherit the affinity. Memory that is first touched during this
+ * time is typically allocated on the NUMA node of these CPUs.
+ */
+class ScopedAffinity {
+private:
+#if defined(__linux__)
+  bool restore_{false};
+  cpu_set_t previous_{};
+#endif
+
+public:
+  explicit ScopedAffinity(const CpuList& cpus) {
+#if defined(__linux__)
+    if (!cpus.empty() && pthread_getaffinity_np(pthread_self(), sizeof(previous_), &previous_) == 0) {
+      restore_ = true;
+      pin_current_thread(cpus);
+    }
+#else
+    (void)cpus;
+#endif
+  }
+
+  ~ScopedAffinity() {
+#if defined(__linux__)
+    if (restore_) {
+      set_thread_affinity(previous_);
+    }
+#endif
+  }
+
+  ScopedAffinity(const ScopedAffinity&) = delete;
+  auto operator=(const ScopedAffinity&) -> ScopedAffinity& = delete;
+};
+
+/// The CPUs of all enclaves that are pinned. Entries are added during construction of the program only.
+class Registry {
+private:
+  std::mutex mutex_;
+  std::unordered_map<const reactor::Environment*, CpuList> cpus_;
+
+public:
+  static auto instance() -> Registry& {
+    static Registry registry;
+    return registry;
+  }
+
+  void add(const reactor::Environment* environment, CpuList cpus) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cpus_[environment] = std::move(cpus);
+  }
+
+  /// Get the CPUs of the given environment, or nullptr if it is not pinned.
+  auto find(const reactor::Environment* environment) -> const CpuList* {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cpus_.find(environment);
+    return it == cpus_.end() ? nullptr : &it->second;
+  }
+};
+
+/**
+ * Move the calling worker thread to the CPUs of the given environment.
+ *
+ * This is called before each reaction. Only the first reaction of an environment on a thread looks up its
+ * CPUs, afterwards this is a comparison with a thread local pointer.
+ */
+inline void pin_worker(const reactor::Environment* environment) {
+  thread_local const reactor::Environment* pinned_environment{nullptr};
+  if (pinned_environment != environment) {
+    pinned_environment = environment;
+    if (const auto* cpus = Registry::instance().find(environment)) {
+      pin_current_thread(*cpus);
+    }
+  }
+}
+
+} // namespace lfutil::affinity
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Measurements for the benchmark harness of the C++ target.
+ *
+ * If the benchmark target property is set, the generated reactions report their execution to this
+ * header. The counters are only active in the benchmark executable, which is compiled with
+ * LF_BENCHMARK defined. In the regular executable, the calls compile to nothing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::benchmark {
+
+/// Counters of a single run of the program
+class Counters {
+private:
+  std::atomic<std::uint64_t> reactions_{0};
+  std::atomic<std::uint64_t> tags_{0};
+  std::atomic<reactor::TimePoint::rep> first_reaction_time_{0};
+
+  std::mutex mutex_;
+  std::optional<reactor::Tag> last_tag_{};
+
+public:
+  static auto instance() -> Counters& {
+    static Counters counters;
+    return counters;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reactions_.store(0);
+    tags_.store(0);
+    first_reaction_time_.store(0);
+    last_tag_.reset();
+  }
+
+  /// Count a tag when it is observed by any thread for the first time.
+  void observe_tag(const reactor::Tag& tag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!last_tag_.has_value()) {
+      first_reaction_time_.store(reactor::get_physical_time().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    if (!last_tag_.has_value() || *last_tag_ < tag) {
+      last_tag_ = tag;
+      tags_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void count_reaction() noexcept { reactions_.fetch_add(1, std::memory_order_relaxed); }
+
+  [[nodiscard]] auto reactions() const noexcept -> std::uint64_t { return reactions_.load(); }
+  [[nodiscard]] auto tags() const noexcept -> std::uint64_t { return tags_.load(); }
+  [[nodiscard]] auto first_reaction_time() const noexcept -> reactor::TimePoint {
+    return reactor::TimePoint{reactor::Duration{first_reaction_time_.load()}};
+  }
+};
+
+/// Record the execution of a reaction.
+inline void reaction_starts([[maybe_unused]] const reactor::Reactor* reactor) {
+#ifdef LF_BENCHMARK
+  // each thread only reports a tag once, so that the shared state is not touched for every reaction
+  thread_local std::optional<reactor::Tag> last_tag{};
+  const auto& tag = reactor->get_tag();
+  if (!last_tag.has_value() || *last_tag != tag) {
+    last_tag = tag;
+    Counters::instance().observe_tag(tag);
+  }
+  Counters::instance().count_reaction();
+#endif
+}
+
+/// The measurements of a single run
+struct Run {
+  reactor::Duration assembly{0};
+  reactor::Duration startup{0};
+  reactor::Duration execution{0};
+  std::uint64_t tags{0};
+  std::uint64_t reactions{0};
+};
+
+/// Measures consecutive runs of a program and writes the results as JSON.
+class Harness {
+private:
+  const std::string name_;
+  std::vector<Run> runs_;
+  Run current_{};
+  reactor::TimePoint begin_{};
+  reactor::TimePoint startup_{};
+
+  static auto nanoseconds(reactor::Duration duration) -> long long { return static_cast<long long>(duration.count()); }
+
+  static auto median(std::vector<double> values) -> double {
+    if (values.empty()) {
+      return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+  }
+
+public:
+  explicit Harness(std::string name)
+      : name_(std::move(name)) {}
+
+  /// Call before constructing the program.
+  void begin_run() {
+    Counters::instance().reset();
+    current_ = Run{};
+    begin_ = reactor::get_physical_time();
+  }
+
+  /// Call after the program was assembled, directly before calling startup.
+  void assembled() {
+    startup_ = reactor::get_physical_time();
+    current_.assembly = startup_ - begin_;
+  }
+
+  /// Call after execution terminated.
+  void end_run() {
+    auto end = reactor::get_physical_time();
+    const auto& counters = Counters::instance();
+    current_.tags = counters.tags();
+    current_.reactions = counters.reactions();
+    auto first_reaction = current_.reactions > 0 ? counters.first_reaction_time() : end;
+    current_.startup = first_reaction - startup_;
+    current_.execution = end - first_reaction;
+    runs_.push_back(current_);
+  }
+
+  void write_json(std::ostream& os) const {
+    std::vector<double> assembly;
+    std::vector<double> startup;
+    std::vector<double> per_tag;
+    std::vector<double> reactions_per_second;
+    os << "{\n  \"benchmark\": \"" << name_ << "\",\n  \"runs\": [";
+    for (std::size_t i{0}; i < runs_.size(); i++) {
+      const auto& run = runs_[i];
+      double execution_seconds = std::chrono::duration<double>(run.execution).count();
+      double ns_per_tag = run.tags > 0 ? static_cast<double>(run.execution.count()) / static_cast<double>(run.tags) : 0.0;
+      double rate = execution_seconds > 0.0 ? static_cast<double>(run.reactions) / execution_seconds : 0.0;
+      assembly.push_back(static_cast<double>(run.assembly.count()));
+      startup.push_back(static_cast<double>(run.startup.count()));
+      per_tag.push_back(ns_per_tag);
+      reactions_per_second.push_back(rate);
+      os << (i == 0 ? "\n" : ",\n") << "    {\"assembly_ns\": " << nanoseconds(run.assembly)
+         << ", \"startup_ns\": " << nanoseconds(run.startup) << ", \"execution_ns\": " << nanoseconds(run.execution)
+         << ", \"tags\": " << run.tags << ", \"reactions\": " << run.reactions << ", \"ns_per_tag\": " << ns_per_tag
+         << ", \"reactions_per_second\": " << rate << "}";
+    }
+    os << "\n  ],\n  \"median\": {\"assembly_ns\": " << median(assembly) << ", \"startup_ns\": " << median(startup)
+       << ", \"ns_per_tag\": " << median(per_tag) << ", \"reactions_per_second\": " << median(reactions_per_second)
+       << "}\n}" << std::endl;
+  }
+};
+
+} // namespace lfutil::benchmark
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Loading of main reactor parameters from a configuration file.
+ *
+ * The file is memory mapped where supported and parsed in place. Values are converted directly
+ * into the parameter types, so that also large vectors can be loaded quickly.
+ *
+ * The file consists of lines of the form `name = value`. Lines starting with `#` are comments. A
+ * value may be followed by a comment, which starts with a `#` after a space, e.g.
+ * `period = 100 ms # sampling period`. Comments are not permitted inside values, and thus neither in
+ * vectors that span multiple lines.
+ * Values are written as on the command line, e.g. `42`, `2.5`, `true`, `100 ms` or `forever`.
+ * Strings are either given verbatim or in double quotes with `\"`, `\\`, `\n` and `\t` escapes.
+ * Vectors are written in brackets with comma separated elements and may span multiple lines, e.g.
+ * `coefficients = [0.5, 1.5, 2.5]`. Vectors may be nested.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "time_parser.hh"
+
+namespace lfutil::config {
+
+class ConfigError : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+/// The read only content of a file. The file is memory mapped where supported.
+class MappedFile {
+private:
+  std::string_view content_;
+#if defined(__unix__) || defined(__APPLE__)
+  void* address_{nullptr};
+#else
+  std::string buffer_;
+#endif
+
+public:
+  explicit MappedFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw ConfigError("Could not open config file " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw ConfigError("Could not read config file " + path);
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    if (size > 0) {
+      address_ = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address_ == MAP_FAILED) {
+        address_ = nullptr;
+        ::close(fd);
+        throw ConfigError("Could not map config file " + path);
+      }
+      content_ = std::string_view{static_cast<const char*>(address_), size};
+    }
+    ::close(fd);
+#else
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+      throw ConfigError("Could not open config file " + path);
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    buffer_ = ss.str();
+    content_ = buffer_;
+#endif
+  }
+
+  ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (address_ != nullptr) {
+      ::munmap(address_, content_.size());
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+  [[nodiscard]] auto content() const noexcept -> std::string_view { return content_; }
+};
+
+template <class T> struct is_vector : std::false_type {};
+template <class T, class A> struct is_vector<std::vector<T, A>> : std::true_type {};
+
+constexpr auto is_space(char c) noexcept -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+constexpr auto trim(std::string_view text) noexcept -> std::string_view {
+  while (!text.empty() && (is_space(text.front()) || text.front() == '\n')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (is_space(text.back()) || text.back() == '\n')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+/// Find the end of the quoted string starting at `pos`. Returns npos if the string is not terminated.
+constexpr auto end_of_string(std::string_view text, std::size_t pos) noexcept -> std::size_t {
+  for (pos++; pos < text.size(); pos++) {
+    if (text[pos] == '\\') {
+      pos++;
+    } else if (text[pos] == '"') {
+      return pos + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// Find the end of the bracketed list starting at `pos`. Returns npos if the list is not terminated.
+constexpr auto end_of_list(std::string_view text, std::size_t pos) noexcept -> std::size_t {
+  std::size_t depth{0};
+  while (pos < text.size()) {
+    char c = text[pos];
+    if (c == '"') {
+      pos = end_of_string(text, pos);
+      if (pos == std::string_view::npos) {
+        return pos;
+      }
+      continue;
+    }
+    if (c == '[') {
+      depth++;
+    } else if (c == ']' && --depth == 0) {
+      return pos + 1;
+    }
+    pos++;
+  }
+  return std::string_view::npos;
+}
+
+/// Call `function` for each top level element of a bracketed list.
+template <class F> void for_each_element(std::string_view list, F&& function) {
+  if (list.size() < 2 || list.front() != '[' || list.back() != ']') {
+    throw std::invalid_argument("expected a list in brackets");
+  }
+  list = list.substr(1, list.size() - 2);
+  std::size_t start{0};
+  std::size_t depth{0};
+  for (std::size_t pos{0}; pos <= list.size(); pos++) {
+    if (pos < list.size() && list[pos] == '"') {
+      pos = end_of_string(list, pos);
+      if (pos == std::string_view::npos) {
+        throw std::invalid_argument("unterminated string");
+      }
+      pos--;
+    } else if (pos < list.size() && list[pos] == '[') {
+      depth++;
+    } else if (pos < list.size() && list[pos] == ']') {
+      depth--;
+    } else if (pos == list.size() || (list[pos] == ',' && depth == 0)) {
+      auto element = trim(list.substr(start, pos - start));
+      // permit a trailing comma and empty lists
+      if (!element.empty() || pos != list.size()) {
+        function(element);
+      }
+      start = pos + 1;
+    }
+  }
+}
+
+template <class T> void decode(std::string_view text, T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (text == "true") {
+      value = true;
+    } else if (text == "false") {
+      value = false;
+    } else {
+      throw std::invalid_argument("expected true or false");
+    }
+  } else if constexpr (std::is_same_v<T, char>) {
+    if (text.size() == 3 && text.front() == '\'' && text.back() == '\'') {
+      text = text.substr(1, 1);
+    }
+    if (text.size() != 1) {
+      throw std::invalid_argument("expected a single character");
+    }
+    value = text.front();
+  } else if constexpr (std::is_integral_v<T>) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec == std::errc::result_out_of_range) {
+      throw std::invalid_argument("value out of range");
+    }
+    if (ec != std::errc{} || ptr != text.data() + text.size()) {
+      throw std::invalid_argument("expected an integer");
+    }
+  } else if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    bool valid = ec == std::errc{} && ptr == text.data() + text.size();
+#else
+    // floating point support of std::from_chars is still missing in some standard libraries
+    std::string copy{text};
+    char* end{nullptr};
+    value = static_cast<T>(std::strtold(copy.c_str(), &end));
+    bool valid = !copy.empty() && end == copy.c_str() + copy.size();
+#endif
+    if (!valid) {
+      throw std::invalid_argument("expected a number");
+    }
+  } else if constexpr (std::is_same_v<T, reactor::Duration>) {
+    auto error = time_parser::parse_duration(text, value);
+    if (error != time_parser::ParseError::None) {
+      throw std::invalid_argument(time_parser::describe(error, text));
+    }
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    if (text.empty() || text.front() != '"') {
+      value = text;
+      return;
+    }
+    if (text.size() < 2 || end_of_string(text, 0) != text.size()) {
+      throw std::invalid_argument("malformed string");
+    }
+    value.clear();
+    value.reserve(text.size() - 2);
+    for (std::size_t pos{1}; pos + 1 < text.size(); pos++) {
+      char c = text[pos];
+      if (c == '\\') {
+        c = text[++pos];
+        c = c == 'n' ? '\n' : (c == 't' ? '\t' : c);
+      }
+      value.push_back(c);
+    }
+  } else if constexpr (is_vector<T>::value) {
+    std::size_t size{0};
+    for_each_element(text, [&size](std::string_view) { size++; });
+    value.clear();
+    value.reserve(size);
+    for_each_element(text, [&value](std::string_view element) {
+      typename T::value_type element_value{};
+      decode(element, element_value);
+      value.push_back(std::move(element_value));
+    });
+  } else {
+    // other types are parsed in the same way as on the command line
+    std::stringstream in{std::string{text}};
+    in >> value;
+    if (!in) {
+      throw std::invalid_argument("could not parse value");
+    }
+  }
+}
+
+/**
+ * A parsed configuration file.
+ *
+ * Values are only located when the file is loaded and are converted when they are read.
+ */
+class ConfigFile {
+private:
+  struct Entry {
+    std::string_view value;
+    std::size_t line;
+    bool used{false};
+  };
+
+  const std::string path_;
+  const MappedFile file_;
+  std::unordered_map<std::string_view, Entry> entries_;
+
+  [[noreturn]] void fail(std::size_t line, const std::string& message) const {
+    throw ConfigError(path_ + ":" + std::to_string(line) + ": " + message);
+  }
+
+  void parse() {
+    auto content = file_.content();
+    std::size_t pos{0};
+    std::size_t line{1};
+    auto skip_spaces = [&]() {
+      while (pos < content.size() && is_space(content[pos])) {
+        pos++;
+      }
+    };
+    auto at_line_end = [&]() { return pos == content.size() || content[pos] == '\n'; };
+    auto at_comment = [&]() { return pos < content.size() && content[pos] == '#' && is_space(content[pos - 1]); };
+
+    while (pos < content.size()) {
+      skip_spaces();
+      if (!at_line_end() && content[pos] != '#') {
+        auto name_start = pos;
+        while (pos < content.size() && !is_space(content[pos]) && content[pos] != '=' && content[pos] != '\n') {
+          pos++;
+        }
+        auto name = content.substr(name_start, pos - name_start);
+        skip_spaces();
+        if (name.empty() || at_line_end() || content[pos] != '=') {
+          fail(line, "expected 'name = value'");
+        }
+        pos++;
+        skip_spaces();
+
+        auto value_start = pos;
+        auto value_line = line;
+        if (pos < content.size() && (content[pos] == '[' || content[pos] == '"')) {
+          pos = content[pos] == '[' ? end_of_list(content, pos) : end_of_string(content, pos);
+          if (pos == std::string_view::npos) {
+            fail(value_line, "unterminated value of " + std::string{name});
+          }
+          for (auto i = value_start; i < pos; i++) {
+            line += content[i] == '\n' ? 1 : 0;
+          }
+          skip_spaces();
+          if (!at_line_end() && !at_comment()) {
+            fail(line, "unexpected characters after value of " + std::string{name});
+          }
+        } else {
+          while (!at_line_end() && !at_comment()) {
+            pos++;
+          }
+        }
+        auto value = trim(content.substr(value_start, pos - value_start));
+        if (!entries_.emplace(name, Entry{value, value_line}).second) {
+          fail(value_line, "duplicate parameter " + std::string{name});
+        }
+      }
+      // skip the remainder of the line
+      while (!at_line_end()) {
+        pos++;
+      }
+      if (pos < content.size()) {
+        pos++;
+        line++;
+      }
+    }
+  }
+
+public:
+  explicit ConfigFile(std::string path)
+      : path_(std::move(path))
+      , file_(path_) {
+    parse();
+  }
+
+  /// Read the value of `name` into `value` if the file provides it. Returns whether a value was read.
+  template <class T> auto read(std::string_view name, T& value) -> bool {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+      return false;
+    }
+    it->second.used = true;
+    try {
+      decode(it->second.value, value);
+    } catch (const std::exception& e) {
+      fail(it->second.line, "invalid value for parameter " + std::string{name} + " (" + e.what() + ")");
+    }
+    return true;
+  }
+
+  /// Mark `name` as known without reading its value, e.g. because it was overridden.
+  void ignore(std::string_view name) {
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+      it->second.used = true;
+    }
+  }
+
+  /// Report an error if the file provides a value that was neither read nor ignored.
+  void check_all_used() const {
+    for (const auto& [name, entry] : entries_) {
+      if (!entry.used) {
+        fail(entry.line, "unknown parameter " + std::string{name});
+      }
+    }
+  }
+};
+
+} // namespace lfutil::config
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Batched ingress of values from external threads into the C++ target.
+ *
+ * Scheduling a physical action acquires the scheduler lock and inserts an event for each call.
+ * For high-rate external sources, this lock dominates the cost of passing values into the
+ * program. An ingress queue instead collects values in a lock-free list and only schedules its
+ * physical action when the list transitions from empty to non-empty. The reaction triggered by
+ * the action then drains all values that arrived in the meantime.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::ingress {
+
+/**
+ * A multi-producer, single-consumer queue of values that trigger a physical action.
+ *
+ * Values may be pushed from any thread. Each value is tagged with the physical time at which it
+ * was pushed. Values pushed together by a single call share one time stamp. The queue must only be
+ * drained by reactions of the reactor that owns the physical action.
+ */
+template <class T> class Queue {
+private:
+  struct Node {
+    T value;
+    reactor::TimePoint time;
+    Node* next{nullptr};
+  };
+
+  std::atomic<Node*> head_{nullptr};
+
+  /// Prepend the chain of nodes from first to last and schedule the action if the queue was empty.
+  void push_chain(reactor::PhysicalAction<void>& action, Node* first, Node* last) {
+    Node* head = head_.load(std::memory_order_relaxed);
+    do {
+      last->next = head;
+    } while (!head_.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    // Only the first value after a drain triggers the action. Later values are picked up by the
+    // same reaction.
+    if (head == nullptr) {
+      action.schedule();
+    }
+  }
+
+  static void destroy(Node* node) noexcept {
+    while (node != nullptr) {
+      std::unique_ptr<Node> current{node};
+      node = node->next;
+    }
+  }
+
+public:
+  Queue() = default;
+  ~Queue() { destroy(head_.exchange(nullptr, std::memory_order_acquire)); }
+
+  Queue(const Queue&) = delete;
+  auto operator=(const Queue&) -> Queue& = delete;
+
+  /// Push a single value and schedule the action if necessary.
+  void push(reactor::PhysicalAction<void>& action, T value) {
+    auto* node = new Node{std::move(value), reactor::get_physical_time()};
+    push_chain(action, node, node);
+  }
+
+  /// Push all values of the given range with a single atomic operation.
+  template <class Range> void push_all(reactor::PhysicalAction<void>& action, Range&& values) {
+    auto time = reactor::get_physical_time();
+    Node* first{nullptr};
+    Node* last{nullptr};
+    for (auto&& value : values) {
+      // The list is drained in reverse order, so the newest value goes first.
+      first = new Node{std::forward<decltype(value)>(value), time, first};
+      if (last == nullptr) {
+        last = first;
+      }
+    }
+    if (first != nullptr) {
+      push_chain(action, first, last);
+    }
+  }
+
+  /**
+   * Remove all values from the queue and pass them to the given function in the order they were
+   * pushed.
+   *
+   * The function is invoked either with the value, or with the value and the physical time at which
+   * it was pushed. Return the number of values processed. This may be zero if a previous drain
+   * already processed the values that caused the action to trigger.
+   */
+  template <class F> auto drain(F&& function) -> std::size_t {
+    Node* reversed = head_.exchange(nullptr, std::memory_order_acquire);
+    Node* node{nullptr};
+    while (reversed != nullptr) {
+      Node* next = reversed->next;
+      reversed->next = node;
+      node = reversed;
+      reversed = next;
+    }
+
+    // make sure that the remaining values are freed if the function throws
+    struct Remaining {
+      Node* node;
+      ~Remaining() { destroy(node); }
+    } remaining{node};
+
+    std::size_t count{0};
+    while (remaining.node != nullptr) {
+      std::unique_ptr<Node> current{remaining.node};
+      remaining.node = current->next;
+      if constexpr (std::is_invocable_v<F&, T&&, const reactor::TimePoint&>) {
+        function(std::move(current->value), current->time);
+      } else {
+        function(std::move(current->value));
+      }
+      count++;
+    }
+    return count;
+  }
+
+  /// Return true if no values are waiting to be drained.
+  [[nodiscard]] auto empty() const noexcept -> bool { return head_.load(std::memory_order_acquire) == nullptr; }
+};
+
+} // namespace lfutil::ingress
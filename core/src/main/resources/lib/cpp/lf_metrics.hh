@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Live runtime metrics of the C++ target, served over HTTP in the Prometheus text format.
+ *
+ * As for the statistics, the metrics of a reaction have a single writer at any time and are updated
+ * with relaxed loads and stores. The server thread only reads them when it is scraped, so the
+ * reaction hot path never waits for it and only pays for two clock readings per execution.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::metrics {
+
+class ReactionMetrics;
+
+/// Registry of the metrics of all reactions in the program
+class Registry {
+private:
+  std::mutex mutex_;
+  std::vector<const ReactionMetrics*> metrics_;
+
+public:
+  static auto instance() -> Registry& {
+    static Registry registry;
+    return registry;
+  }
+
+  void add(const ReactionMetrics* metrics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.push_back(metrics);
+  }
+
+  void remove(const ReactionMetrics* metrics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.erase(std::remove(metrics_.begin(), metrics_.end(), metrics), metrics_.end());
+  }
+
+  void write(std::ostream& os);
+};
+
+/// Counters of a single reaction
+class ReactionMetrics {
+private:
+  const reactor::Reaction& reaction_;
+  const std::string environment_;
+  std::atomic<std::uint64_t> executions_{0};
+  std::atomic<std::uint64_t> deadline_misses_{0};
+  std::atomic<std::int64_t> busy_ns_{0};
+  std::atomic<std::int64_t> lag_ns_{0};
+  std::atomic<std::int64_t> last_start_ns_{0};
+
+  template <class T> static void add(std::atomic<T>& counter, T value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  /// Name an environment by the outermost reactor that it executes.
+  static auto environment_name(const reactor::Reactor* reactor) -> std::string {
+    while (reactor->container() != nullptr && reactor->container()->environment() == reactor->environment()) {
+      reactor = reactor->container();
+    }
+    return reactor->fqn();
+  }
+
+public:
+  explicit ReactionMetrics(const reactor::Reaction& reaction)
+      : reaction_(reaction)
+      , environment_(environment_name(reaction.container())) {
+    Registry::instance().add(this);
+  }
+  ~ReactionMetrics() { Registry::instance().remove(this); }
+
+  ReactionMetrics(const ReactionMetrics&) = delete;
+  auto operator=(const ReactionMetrics&) -> ReactionMetrics& = delete;
+
+  /// Record the lag of a reaction that is about to execute and return the start time.
+  auto reaction_starts(const reactor::Reactor* reactor) noexcept -> reactor::TimePoint {
+    auto now = reactor::get_physical_time();
+    lag_ns_.store((now - reactor->get_logical_time()).count(), std::memory_order_relaxed);
+    last_start_ns_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    add<std::uint64_t>(executions_, 1);
+    return now;
+  }
+
+  void reaction_ends(const reactor::TimePoint& start_time) noexcept {
+    add<std::int64_t>(busy_ns_, (reactor::get_physical_time() - start_time).count());
+  }
+
+  void deadline_missed() noexcept { add<std::uint64_t>(deadline_misses_, 1); }
+
+  [[nodiscard]] auto name() const -> std::string { return reaction_.fqn(); }
+  [[nodiscard]] auto environment() const noexcept -> const std::string& { return environment_; }
+  /// The level of the reaction is assigned when the environment is assembled.
+  [[nodiscard]] auto level() const noexcept -> std::size_t { return reaction_.index(); }
+  [[nodiscard]] auto executions() const noexcept -> std::uint64_t { return executions_.load(std::memory_order_relaxed); }
+  [[nodiscard]] auto deadline_misses() const noexcept -> std::uint64_t {
+    return deadline_misses_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] auto busy_ns() const noexcept -> std::int64_t { return busy_ns_.load(std::memory_order_relaxed); }
+  [[nodiscard]] auto lag_ns() const noexcept -> std::int64_t { return lag_ns_.load(std::memory_order_relaxed); }
+  [[nodiscard]] auto last_start_ns() const noexcept -> std::int64_t {
+    return last_start_ns_.load(std::memory_order_relaxed);
+  }
+};
+
+/// Quote a label value of the Prometheus text format.
+inline auto quote(const std::string& value) -> std::string {
+  std::string quoted{"\""};
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c == '\n') {
+      quoted += "\\n";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + '"';
+}
+
+/**
+ * Write all metrics in the Prometheus text format.
+ *
+ * The lag of an environment is the lag of the reaction that started most recently. Worker
+ * utilization can be derived from the rate of the busy time of an environment divided by its
+ * number of workers.
+ */
+inline void Registry::write(std::ostream& os) {
+  struct Environment {
+    std::uint64_t executions{0};
+    std::uint64_t deadline_misses{0};
+    std::int64_t busy_ns{0};
+    std::int64_t lag_ns{0};
+    std::int64_t last_start_ns{-1};
+  };
+  std::map<std::string, Environment> environments;
+  std::map<std::pair<std::string, std::size_t>, std::uint64_t> levels;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << "# TYPE lf_reaction_executions_total counter\n";
+  for (const auto* metrics : metrics_) {
+    os << "lf_reaction_executions_total{reaction=" << quote(metrics->name()) << "} " << metrics->executions() << '\n';
+  }
+  os << "# TYPE lf_reaction_deadline_misses_total counter\n";
+  for (const auto* metrics : metrics_) {
+    os << "lf_reaction_deadline_misses_total{reaction=" << quote(metrics->name()) << "} "
+       << metrics->deadline_misses() << '\n';
+  }
+  os << "# TYPE lf_reaction_busy_seconds_total counter\n";
+  for (const auto* metrics : metrics_) {
+    os << "lf_reaction_busy_seconds_total{reaction=" << quote(metrics->name()) << "} " << metrics->busy_ns() * 1e-9
+       << '\n';
+  }
+
+  for (const auto* metrics : metrics_) {
+    auto& environment = environments[metrics->environment()];
+    environment.executions += metrics->executions();
+    environment.deadline_misses += metrics->deadline_misses();
+    environment.busy_ns += metrics->busy_ns();
+    if (auto last_start = metrics->last_start_ns(); metrics->executions() != 0 && last_start > environment.last_start_ns) {
+      environment.last_start_ns = last_start;
+      environment.lag_ns = metrics->lag_ns();
+    }
+    levels[{metrics->environment(), metrics->level()}] += metrics->executions();
+  }
+  os << "# TYPE lf_environment_lag_seconds gauge\n";
+  for (const auto& [name, environment] : environments) {
+    os << "lf_environment_lag_seconds{environment=" << quote(name) << "} " << environment.lag_ns * 1e-9 << '\n';
+  }
+  os << "# TYPE lf_environment_busy_seconds_total counter\n";
+  for (const auto& [name, environment] : environments) {
+    os << "lf_environment_busy_seconds_total{environment=" << quote(name) << "} " << environment.busy_ns * 1e-9
+       << '\n';
+  }
+  os << "# TYPE lf_environment_deadline_misses_total counter\n";
+  for (const auto& [name, environment] : environments) {
+    os << "lf_environment_deadline_misses_total{environment=" << quote(name) << "} " << environment.deadline_misses
+       << '\n';
+  }
+  os << "# TYPE lf_level_executions_total counter\n";
+  for (const auto& [key, executions] : levels) {
+    os << "lf_level_executions_total{environment=" << quote(key.first) << ",level=\"" << key.second << "\"} "
+       << executions << '\n';
+  }
+}
+
+/**
+ * A minimal HTTP server that answers each request with the current metrics.
+ *
+ * The server accepts one connection at a time on its own thread, which is sufficient for periodic
+ * scrapes. It listens on the loopback interface unless another IPv4 address is given, so that the
+ * metrics are not exposed to the network by default. It must be created after the program is assembled, so that the levels of all reactions
+ * are known.
+ */
+class Server {
+#if defined(__unix__) || defined(__APPLE__)
+private:
+  int socket_{-1};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+  static void send_all(int client, const std::string& data) {
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+    std::size_t sent{0};
+    while (sent < data.size()) {
+      auto result = ::send(client, data.data() + sent, data.size() - sent, flags);
+      if (result <= 0) {
+        return;
+      }
+      sent += static_cast<std::size_t>(result);
+    }
+  }
+
+  static void handle(int client) {
+    // do not let a stalled client block the server
+    timeval timeout{1, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe{1};
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+      auto received = ::recv(client, buffer, sizeof(buffer), 0);
+      if (received <= 0) {
+        return;
+      }
+      request.append(buffer, static_cast<std::size_t>(received));
+    }
+
+    std::ostringstream response;
+    if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET / ", 0) == 0) {
+      std::ostringstream body;
+      Registry::instance().write(body);
+      auto content = body.str();
+      response << "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " << content.size()
+               << "\r\nConnection: close\r\n\r\n"
+               << content;
+    } else {
+      response << "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    send_all(client, response.str());
+  }
+
+  void serve() {
+    while (!stop_.load(std::memory_order_relaxed)) {
+      pollfd fd{socket_, POLLIN, 0};
+      // wake up regularly to check if the server is stopped
+      if (::poll(&fd, 1, 100) <= 0) {
+        continue;
+      }
+      int client = ::accept(socket_, nullptr, nullptr);
+      if (client >= 0) {
+        handle(client);
+        ::close(client);
+      }
+    }
+  }
+
+public:
+  explicit Server(unsigned port, const std::string& host = "127.0.0.1") {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    if (port > 65535 || ::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+      reactor::log::Error() << "Cannot serve metrics on " << host << ':' << port << ": invalid address";
+      return;
+    }
+    socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int reuse{1};
+    if (socket_ < 0 || ::setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        ::bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(socket_, 8) != 0) {
+      reactor::log::Error() << "Cannot serve metrics on " << host << ':' << port << ": " << std::strerror(errno);
+      if (socket_ >= 0) {
+        ::close(socket_);
+        socket_ = -1;
+      }
+      return;
+    }
+    reactor::log::Info() << "Serving metrics on " << host << ':' << port;
+    thread_ = std::thread([this]() { serve(); });
+  }
+
+  ~Server() {
+    stop_.store(true);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (socket_ >= 0) {
+      ::close(socket_);
+    }
+  }
+#else
+public:
+  explicit Server(unsigned port, [[maybe_unused]] const std::string& host = "127.0.0.1") {
+    reactor::log::Warn() << "Metrics cannot be served on this platform (port " << port << ")";
+  }
+#endif
+
+  Server(const Server&) = delete;
+  auto operator=(const Server&) -> Server& = delete;
+};
+
+} // namespace lfutil::metrics
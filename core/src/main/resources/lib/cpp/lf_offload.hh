@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Offloading of blocking calls from reactions in the C++ target.
+ *
+ * A reaction that performs a blocking call, e.g. to a database or a network service, occupies a
+ * worker for the duration of the call. An offload executor runs such calls on its own threads
+ * instead, and delivers their results through a physical action. The reaction returns
+ * immediately, and the result is processed by the reaction triggered by the action at a later tag.
+ * Determinism is thus retained at tag boundaries, as with any other physical action.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <reactor-cpp/logging.hh>
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::offload {
+
+/**
+ * A pool of threads that execute blocking calls and schedule a physical action with their results.
+ *
+ * The executor should be stopped in a shutdown reaction, so that no action is scheduled after the
+ * program terminated. Stopping drops the calls that did not start yet and waits for the running
+ * ones, whose results are discarded.
+ */
+class Executor {
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  bool stopping_{false};
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  void push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        reactor::log::Warn() << "Ignoring a call submitted to a stopped offload executor";
+        return;
+      }
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+  template <class T, class... V> void schedule(reactor::PhysicalAction<T>& action, V&&... value) {
+    // hold the lock, so that stop() cannot return while the action is being scheduled
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_) {
+      action.schedule(std::forward<V>(value)...);
+    }
+  }
+
+public:
+  explicit Executor(std::size_t num_threads = std::thread::hardware_concurrency()) {
+    threads_.reserve(num_threads);
+    for (std::size_t i{0}; i < std::max<std::size_t>(num_threads, 1); i++) {
+      threads_.emplace_back([this]() { run(); });
+    }
+  }
+  ~Executor() { stop(); }
+
+  Executor(const Executor&) = delete;
+  auto operator=(const Executor&) -> Executor& = delete;
+
+  /**
+   * Execute the given function on a thread of the executor and schedule the action with its result.
+   *
+   * The function must not access the state of the reactor or any ports, as it runs concurrently to
+   * the reactions. If the function throws, the error is logged and the action is not scheduled.
+   */
+  template <class T, class F> void submit(reactor::PhysicalAction<T>& action, F&& function) {
+    push([this, &action, function = std::forward<F>(function)]() mutable {
+      try {
+        if constexpr (std::is_void_v<T>) {
+          function();
+          schedule(action);
+        } else {
+          schedule(action, function());
+        }
+      } catch (const std::exception& e) {
+        reactor::log::Error() << "Offloaded call to " << action.fqn() << " failed: " << e.what();
+      } catch (...) {
+        reactor::log::Error() << "Offloaded call to " << action.fqn() << " failed with an unknown exception";
+      }
+    });
+  }
+
+  /**
+   * Drop the calls that did not start yet, wait for the running ones and join the threads of the
+   * executor. Once this returns, the executor does not schedule any action.
+   */
+  void stop() {
+    std::deque<std::function<void()>> dropped;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      dropped.swap(tasks_);
+    }
+    cv_.notify_all();
+    if (!dropped.empty()) {
+      reactor::log::Warn() << "Dropped " << dropped.size() << " offloaded calls that did not start before stopping";
+    }
+    for (auto& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+};
+
+} // namespace lfutil::offload
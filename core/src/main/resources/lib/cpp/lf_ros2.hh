@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Exchange of messages between reactions and ROS2 without copying them.
+ *
+ * A message that is published as a std::unique_ptr is handed over to the subscriptions in the same
+ * process without copying or serializing it, if the node uses intra-process communication (see the
+ * ros2-intra-process target property). Messages for other processes are constructed in memory
+ * loaned from the middleware, if it supports this. Received messages are moved into the value of a
+ * physical action.
+ *
+ * This header may only be included in programs that are compiled with the ros2 target property.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <rclcpp/rclcpp.hpp>
+#include <reactor-cpp/reactor-cpp.hh>
+
+#include "lfutil.hh"
+
+namespace lfutil::ros2 {
+
+/// Publish a message, moving it to subscriptions in the same process or into loaned memory.
+template <class Message>
+void publish(rclcpp::Publisher<Message>& publisher, std::type_identity_t<Message>&& message) {
+  // loaned messages bypass the intra-process hand-off, so they are only used without local readers
+  if (publisher.get_intra_process_subscription_count() == 0 && publisher.can_loan_messages()) {
+    auto loaned = publisher.borrow_loaned_message();
+    loaned.get() = std::move(message);
+    publisher.publish(std::move(loaned));
+  } else {
+    publisher.publish(std::make_unique<Message>(std::move(message)));
+  }
+}
+
+/**
+ * Publish the value of an input port.
+ *
+ * The value is taken with lfutil::take(), so that it is only copied if other reactions read the
+ * port as well. Without a copy, the message is moved out of the value that the port still refers
+ * to. This is safe because take() only skips the copy for an exclusive input, whose value reaches
+ * no other reader, including readers behind delayed or physical connections, and the port is not
+ * read again after the reaction.
+ */
+template <class Message> void publish(rclcpp::Publisher<Message>& publisher, TakenValue<Message>&& value) {
+  publish(publisher, std::move(*value));
+}
+
+/// Create a subscription that schedules the given physical action with each received message.
+template <class Message>
+auto subscribe(rclcpp::Node& node, const std::string& topic, const rclcpp::QoS& qos,
+               reactor::PhysicalAction<Message>& action) -> typename rclcpp::Subscription<Message>::SharedPtr {
+  return node.create_subscription<Message>(topic, qos, [&action](std::unique_ptr<Message> message) {
+    action.schedule(reactor::make_mutable_value<Message>(std::move(*message)));
+  });
+}
+
+} // namespace lfutil::ros2
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Per-reaction execution time and lag histograms for the C++ target.
+ *
+ * A reaction is executed by at most one worker at a time, and consecutive executions are ordered by
+ * the scheduler. Thus, each histogram has a single writer at any time and can be updated with
+ * relaxed loads and stores instead of atomic read-modify-write operations. The atomics only make
+ * concurrent reads from the dumping thread well defined.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <pthread.h>
+#endif
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::statistics {
+
+/**
+ * A log-linear histogram of durations in nanoseconds.
+ *
+ * Each power of two is divided into 8 linear sub-buckets, which bounds the relative error of
+ * reported values to 12.5%. Values of 2^40 ns (about 18 minutes) or more are counted in the last
+ * bucket.
+ */
+class Histogram {
+public:
+  static constexpr unsigned sub_bucket_bits = 3;
+  static constexpr std::uint64_t sub_buckets = 1u << sub_bucket_bits;
+  static constexpr unsigned max_exponent = 40;
+  static constexpr std::size_t num_buckets = (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+
+private:
+  std::array<std::atomic<std::uint64_t>, num_buckets> counts_{};
+  std::atomic<std::uint64_t> max_{0};
+
+public:
+  /// Increment a counter that is only written by one thread at a time.
+  static void increment(std::atomic<std::uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  static constexpr auto bucket_index(std::uint64_t value) noexcept -> std::size_t {
+    if (value < sub_buckets) {
+      return value;
+    }
+    unsigned exponent = std::bit_width(value) - 1;
+    if (exponent >= max_exponent) {
+      return num_buckets - 1;
+    }
+    auto sub_bucket = (value >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+    return ((exponent - sub_bucket_bits + 1) << sub_bucket_bits) + sub_bucket;
+  }
+
+  /// Return the largest value that is counted in the given bucket.
+  static constexpr auto bucket_upper_bound(std::size_t index) noexcept -> std::uint64_t {
+    if (index < sub_buckets) {
+      return index;
+    }
+    unsigned exponent = (index >> sub_bucket_bits) + sub_bucket_bits - 1;
+    auto sub_bucket = index & (sub_buckets - 1);
+    auto width = std::uint64_t{1} << (exponent - sub_bucket_bits);
+    return ((sub_buckets + sub_bucket) << (exponent - sub_bucket_bits)) + width - 1;
+  }
+
+  void record(reactor::Duration duration) noexcept {
+    auto value = static_cast<std::uint64_t>(std::max(duration.count(), reactor::Duration::rep{0}));
+    increment(counts_[bucket_index(value)]);
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] auto count() const noexcept -> std::uint64_t {
+    std::uint64_t total{0};
+    for (const auto& counter : counts_) {
+      total += counter.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  [[nodiscard]] auto max() const noexcept -> std::uint64_t { return max_.load(std::memory_order_relaxed); }
+
+  /// Return an upper bound of the value below which the given fraction of all values lies.
+  [[nodiscard]] auto percentile(double fraction) const noexcept -> std::uint64_t {
+    auto total = count();
+    if (total == 0) {
+      return 0;
+    }
+    auto target = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    std::uint64_t cumulative{0};
+    for (std::size_t i{0}; i < num_buckets; i++) {
+      cumulative += counts_[i].load(std::memory_order_relaxed);
+      if (cumulative >= target) {
+        return std::min(bucket_upper_bound(i), max());
+      }
+    }
+    return max();
+  }
+};
+
+class ReactionStatistics;
+
+/// Registry of the statistics of all reactions in the program
+class Registry {
+private:
+  std::mutex mutex_;
+  std::vector<const ReactionStatistics*> statistics_;
+
+public:
+  static auto instance() -> Registry& {
+    static Registry registry;
+    return registry;
+  }
+
+  void add(const ReactionStatistics* statistics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.push_back(statistics);
+  }
+
+  void remove(const ReactionStatistics* statistics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.erase(std::remove(statistics_.begin(), statistics_.end(), statistics), statistics_.end());
+  }
+
+  void dump(std::ostream& os);
+};
+
+/// Execution time and lag histograms of a single reaction
+class ReactionStatistics {
+private:
+  const std::string name_;
+  Histogram execution_time_;
+  Histogram lag_;
+  std::atomic<std::uint64_t> deadline_misses_{0};
+
+public:
+  explicit ReactionStatistics(std::string name)
+      : name_(std::move(name)) {
+    Registry::instance().add(this);
+  }
+  ~ReactionStatistics() { Registry::instance().remove(this); }
+
+  ReactionStatistics(const ReactionStatistics&) = delete;
+  auto operator=(const ReactionStatistics&) -> ReactionStatistics& = delete;
+
+  /// Record the lag of a reaction that is about to execute and return the start time.
+  auto reaction_starts(const reactor::Reactor* reactor) noexcept -> reactor::TimePoint {
+    auto now = reactor::get_physical_time();
+    lag_.record(now - reactor->get_logical_time());
+    return now;
+  }
+
+  void reaction_ends(const reactor::TimePoint& start_time) noexcept {
+    execution_time_.record(reactor::get_physical_time() - start_time);
+  }
+
+  void deadline_missed() noexcept { Histogram::increment(deadline_misses_); }
+
+  void dump(std::ostream& os) const {
+    auto executions = execution_time_.count();
+    auto misses = deadline_misses_.load(std::memory_order_relaxed);
+    if (executions == 0 && misses == 0) {
+      return;
+    }
+    auto print = [&os](const char* label, const Histogram& histogram) {
+      os << "  " << std::left << std::setw(20) << label << std::right << " p50 " << std::setw(12)
+         << histogram.percentile(0.5) << " p90 " << std::setw(12) << histogram.percentile(0.9) << " p99 "
+         << std::setw(12) << histogram.percentile(0.99) << " p99.9 " << std::setw(12) << histogram.percentile(0.999)
+         << " max " << std::setw(12) << histogram.max() << '\n';
+    };
+    os << name_ << ": " << executions << " executions, " << misses << " deadline misses\n";
+    print("execution time [ns]", execution_time_);
+    print("lag [ns]", lag_);
+  }
+};
+
+inline void Registry::dump(std::ostream& os) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << "---- Reaction statistics ----\n";
+  for (const auto* statistics : statistics_) {
+    statistics->dump(os);
+  }
+  os << "-----------------------------" << std::endl;
+}
+
+inline void dump() { Registry::instance().dump(std::cout); }
+
+/**
+ * Dump the statistics whenever the process receives SIGUSR1.
+ *
+ * The signal is blocked in the constructing thread and in all threads created afterwards. A
+ * dedicated thread waits for it, so that the statistics are not printed from a signal handler. The
+ * object must therefore be created before the runtime starts its worker threads.
+ */
+class DumpOnSignal {
+#if defined(__unix__) || defined(__APPLE__)
+private:
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+public:
+  DumpOnSignal() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    thread_ = std::thread([this, signals]() {
+      int signal{0};
+      while (sigwait(&signals, &signal) == 0 && !stop_.load()) {
+        dump();
+      }
+    });
+  }
+
+  ~DumpOnSignal() {
+    stop_.store(true);
+    pthread_kill(thread_.native_handle(), SIGUSR1);
+    thread_.join();
+  }
+#endif
+};
+
+} // namespace lfutil::statistics
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2024, TU Dresden.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * A tracing backend for the C++ target that writes the binary trace format of the C target.
+ *
+ * Each thread records events into its own buffer without any synchronization. Full buffers are
+ * handed to a writer thread, which appends them to the trace file, so that file I/O never happens
+ * on a worker thread. The resulting .lft files can be processed by the tools of the C target
+ * (e.g. trace_to_csv or trace_to_chrome).
+ *
+ * The C format has no dedicated events for values passed between local ports. Sends and receives
+ * are therefore recorded as schedule_called events whose trigger is the output port that was set
+ * or the input port that is read by the starting reaction.
+ *
+ * The trace is written to the file given by the trace-file-name option of the tracing target
+ * property, or to <program>.lft by default. The runtime is still built with REACTOR_CPP_TRACE, so
+ * the LTTng tracepoints of reactor-cpp remain available next to this backend.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <reactor-cpp/reactor-cpp.hh>
+
+namespace lfutil::trace {
+
+/// Event types as defined by the trace format of the C target
+enum class Event : int {
+  ReactionStarts = 0,
+  ReactionEnds = 1,
+  ReactionDeadlineMissed = 2,
+  ScheduleCalled = 3,
+  SchedulerAdvancingTimeEnds = 9,
+};
+
+/// Kinds of entries in the object table, as defined by _lf_trace_object_t of the C target
+enum class ObjectType : int {
+  Reactor = 0,
+  Trigger = 1,
+};
+
+/// An entry in the object table that maps the pointers in the records to names
+struct ObjectDescription {
+  const void* pointer;
+  const void* trigger;
+  ObjectType type;
+  std::string description;
+};
+
+/// A single trace record. The layout matches trace_record_t of the C target.
+struct Record {
+  int event_type;
+  const void* pointer;
+  int src_id;
+  int dst_id;
+  std::int64_t logical_time;
+  std::uint32_t microstep;
+  std::int64_t physical_time;
+  const void* trigger;
+  std::int64_t extra_delay;
+};
+
+constexpr std::size_t buffer_capacity = 2048;
+
+struct Buffer {
+  std::array<Record, buffer_capacity> records;
+  std::size_t size{0};
+};
+
+class Tracer {
+private:
+  static constexpr std::int64_t no_start_time = std::numeric_limits<std::int64_t>::min();
+
+  std::atomic<bool> active_{false};
+  std::atomic<int> next_thread_id_{0};
+  std::atomic<std::int64_t> start_time_{no_start_time};
+
+  std::ofstream file_;
+  std::vector<ObjectDescription> object_table_;
+  bool header_written_{false};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<Buffer>> full_buffers_;
+  std::vector<std::unique_ptr<Buffer>> free_buffers_;
+  bool stop_requested_{false};
+  std::thread writer_;
+
+  Tracer() = default;
+
+  void register_reactor(const reactor::Reactor* reactor) {
+    object_table_.push_back({reactor, nullptr, ObjectType::Reactor, reactor->fqn()});
+    for (const auto* action : reactor->actions()) {
+      object_table_.push_back({reactor, action, ObjectType::Trigger, action->fqn()});
+    }
+    for (const auto* port : reactor->inputs()) {
+      object_table_.push_back({reactor, port, ObjectType::Trigger, port->fqn()});
+    }
+    for (const auto* port : reactor->outputs()) {
+      object_table_.push_back({reactor, port, ObjectType::Trigger, port->fqn()});
+    }
+    for (const auto* child : reactor->reactors()) {
+      register_reactor(child);
+    }
+  }
+
+  void write_header() {
+    auto start_time = start_time_.load();
+    if (start_time == no_start_time) {
+      start_time = 0;
+    }
+    auto table_size = static_cast<int>(object_table_.size());
+    file_.write(reinterpret_cast<const char*>(&start_time), sizeof(start_time));
+    file_.write(reinterpret_cast<const char*>(&table_size), sizeof(table_size));
+    for (const auto& object : object_table_) {
+      auto type = static_cast<int>(object.type);
+      file_.write(reinterpret_cast<const char*>(&object.pointer), sizeof(object.pointer));
+      file_.write(reinterpret_cast<const char*>(&object.trigger), sizeof(object.trigger));
+      file_.write(reinterpret_cast<const char*>(&type), sizeof(type));
+      file_.write(object.description.c_str(), static_cast<std::streamsize>(object.description.size() + 1));
+    }
+    header_written_ = true;
+  }
+
+  void write_buffer(const Buffer& buffer) {
+    if (!header_written_) {
+      write_header();
+    }
+    auto size = static_cast<int>(buffer.size);
+    file_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file_.write(reinterpret_cast<const char*>(buffer.records.data()),
+                static_cast<std::streamsize>(buffer.size * sizeof(Record)));
+  }
+
+  void run_writer() {
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    bool stop{false};
+    while (!stop) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_requested_ || !full_buffers_.empty(); });
+        std::swap(buffers, full_buffers_);
+        stop = stop_requested_;
+      }
+      for (const auto& buffer : buffers) {
+        write_buffer(*buffer);
+        buffer->size = 0;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::move(buffers.begin(), buffers.end(), std::back_inserter(free_buffers_));
+      }
+      buffers.clear();
+    }
+    if (!header_written_) {
+      write_header();
+    }
+    file_.close();
+  }
+
+public:
+  static auto instance() -> Tracer& {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  [[nodiscard]] auto active() const noexcept -> bool { return active_.load(std::memory_order_relaxed); }
+  auto register_thread() noexcept -> int { return next_thread_id_.fetch_add(1, std::memory_order_relaxed); }
+
+  void set_start_time(std::int64_t time) noexcept {
+    auto expected = no_start_time;
+    start_time_.compare_exchange_strong(expected, time, std::memory_order_relaxed);
+  }
+
+  /// Open the trace file and start the writer thread. Must be called after assembly and before startup.
+  void start(const std::string& file_name, const reactor::Reactor* main) {
+    file_.open(file_name, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+      reactor::log::Error() << "Could not open trace file " << file_name;
+      return;
+    }
+    register_reactor(main);
+    writer_ = std::thread([this]() { run_writer(); });
+    active_.store(true);
+  }
+
+  /// Stop tracing, write all pending records and close the trace file. Must be called after execution terminated.
+  void stop();
+
+  /// Hand a full buffer to the writer thread and get an empty buffer in return.
+  auto exchange(std::unique_ptr<Buffer> full) -> std::unique_ptr<Buffer> {
+    std::unique_ptr<Buffer> empty{nullptr};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!stop_requested_) {
+        full_buffers_.emplace_back(std::move(full));
+      }
+      if (!free_buffers_.empty()) {
+        empty = std::move(free_buffers_.back());
+        free_buffers_.pop_back();
+      }
+    }
+    cv_.notify_one();
+    if (full != nullptr) {
+      // tracing was stopped already and the records are dropped
+      full->size = 0;
+      return full;
+    }
+    return empty != nullptr ? std::move(empty) : std::make_unique<Buffer>();
+  }
+};
+
+/// The trace buffer of the current thread
+class ThreadBuffer {
+private:
+  std::unique_ptr<Buffer> buffer_{std::make_unique<Buffer>()};
+  int thread_id_{Tracer::instance().register_thread()};
+  std::int64_t last_logical_time_{std::numeric_limits<std::int64_t>::min()};
+  std::uint32_t last_microstep_{0};
+
+public:
+  ~ThreadBuffer() { flush(); }
+
+  void flush() {
+    if (buffer_->size > 0) {
+      buffer_ = Tracer::instance().exchange(std::move(buffer_));
+    }
+  }
+
+  void record(Event event, const reactor::Reactor* reactor, int reaction_index, const void* trigger) {
+    const auto& tag = reactor->get_tag();
+    auto logical_time = tag.time_point().time_since_epoch().count();
+    auto microstep = static_cast<std::uint32_t>(tag.micro_step());
+    auto physical_time = reactor::get_physical_time().time_since_epoch().count();
+
+    if (logical_time != last_logical_time_ || microstep != last_microstep_) {
+      // this thread observes a new tag for the first time
+      Tracer::instance().set_start_time(logical_time);
+      last_logical_time_ = logical_time;
+      last_microstep_ = microstep;
+      append(Record{static_cast<int>(Event::SchedulerAdvancingTimeEnds), nullptr, thread_id_, -1, logical_time,
+                    microstep, physical_time, nullptr, 0});
+    }
+    // as in the C target, the source is the worker and the destination is the reaction
+    append(Record{static_cast<int>(event), reactor, thread_id_, reaction_index, logical_time, microstep, physical_time,
+                  trigger, 0});
+  }
+
+  void append(const Record& record) {
+    buffer_->records[buffer_->size++] = record;
+    if (buffer_->size == buffer_capacity) {
+      flush();
+    }
+  }
+};
+
+inline auto thread_buffer() -> ThreadBuffer& {
+  thread_local ThreadBuffer buffer;
+  return buffer;
+}
+
+inline void Tracer::stop() {
+  if (!active_.exchange(false)) {
+    return;
+  }
+  thread_buffer().flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  cv_.notify_one();
+  writer_.join();
+}
+
+inline void start(const std::string& file_name, const reactor::Reactor* main) {
+  Tracer::instance().start(file_name, main);
+}
+
+inline void stop() { Tracer::instance().stop(); }
+
+inline void record(Event event, const reactor::Reactor* reactor, int reaction_index, const void* trigger = nullptr) {
+  if (Tracer::instance().active()) {
+    thread_buffer().record(event, reactor, reaction_index, trigger);
+  }
+}
+
+inline void reaction_starts(const reactor::Reactor* reactor, int reaction_index) {
+  record(Event::ReactionStarts, reactor, reaction_index);
+}
+
+inline void reaction_ends(const reactor::Reactor* reactor, int reaction_index) {
+  record(Event::ReactionEnds, reactor, reaction_index);
+}
+
+inline void deadline_missed(const reactor::Reactor* reactor, int reaction_index) {
+  record(Event::ReactionDeadlineMissed, reactor, reaction_index);
+}
+
+/// Record an event for each present port in `ports`, which may be a port or a multiport.
+template <class P> void present_ports(const reactor::Reactor* reactor, int reaction_index, const P& ports) {
+  if constexpr (std::is_base_of_v<reactor::BasePort, P>) {
+    if (ports.is_present()) {
+      record(Event::ScheduleCalled, reactor, reaction_index, &ports);
+    }
+  } else {
+    for (const auto& port : ports) {
+      present_ports(reactor, reaction_index, port);
+    }
+  }
+}
+
+/// Record a send event for each present output port in `ports` after a reaction finished.
+template <class P> void ports_sent(const reactor::Reactor* reactor, int reaction_index, const P& ports) {
+  if (Tracer::instance().active()) {
+    present_ports(reactor, reaction_index, ports);
+  }
+}
+
+/// Record a receive event for each present input port in `ports` before a reaction starts.
+template <class P> void ports_received(const reactor::Reactor* reactor, int reaction_index, const P& ports) {
+  if (Tracer::instance().active()) {
+    present_ports(reactor, reaction_index, ports);
+  }
+}
+
+} // namespace lfutil::trace
@@ -24,6 +24,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <reactor-cpp/logging.hh>
 #include <reactor-cpp/reactor-cpp.hh>
 
@@ -45,6 +51,48 @@ template <class T> void after_forward(const reactor::Action<T>* action, reactor:
   }
 }
 
+/**
+ * The value of an input port, taken for modification by a reaction.
+ *
+ * The value can be modified through the pointer interface and forwarded to an output with
+ * `out.set(value.release())`, which does not copy it again.
+ */
+template <class T> class TakenValue {
+private:
+  reactor::ImmutableValuePtr<T> value_;
+
+public:
+  explicit TakenValue(reactor::ImmutableValuePtr<T>&& value)
+      : value_(std::move(value)) {}
+
+  // The value was allocated as a mutable object. It is only accessed as const through the
+  // immutable pointer, so that modifying it is safe if no one else reads it.
+  auto get() const noexcept -> T* { return const_cast<T*>(value_.get()); }
+  auto operator*() const noexcept -> T& { return *get(); }
+  auto operator->() const noexcept -> T* { return get(); }
+  explicit operator bool() const noexcept { return static_cast<bool>(value_); }
+
+  /// Give up the value, e.g. to forward it to an output port.
+  auto release() noexcept -> reactor::ImmutableValuePtr<T> { return std::move(value_); }
+};
+
+/**
+ * Take the value of an input that is only read by the calling reaction.
+ *
+ * The code generator passes an input by non-const reference only if it determined that the
+ * received values are sent to no other reader, neither directly nor through a delayed or physical
+ * connection. In this case, the value is returned without copying it. The writer of the value must
+ * not hold on to it after setting the port.
+ */
+template <class T> auto take(reactor::Input<T>& port) -> TakenValue<T> {
+  return TakenValue<T>{reactor::ImmutableValuePtr<T>{port.get()}};
+}
+
+/// Take a copy of the value of an input that is shared with other readers.
+template <class T> auto take(const reactor::Input<T>& port) -> TakenValue<T> {
+  return TakenValue<T>{reactor::ImmutableValuePtr<T>{port.get().get_mutable_copy()}};
+}
+
 class LFScope {
 private:
   reactor::Reactor* reactor;
@@ -63,39 +111,127 @@ public:
   void request_stop() const { return environment()->sync_shutdown(); }
 };
 
-template <class PortPtr>
-void bind_multiple_ports(std::vector<PortPtr>& left_ports, std::vector<PortPtr>& right_ports, bool repeat_left,
-                         std::function<void(PortPtr, PortPtr)> connect) {
-  if (repeat_left) {
-    auto l_size = left_ports.size();
-    auto r_size = right_ports.size();
-    // divide and round up
-    auto repetitions = r_size / l_size + (r_size % l_size != 0);
-    // repeat repetitions-1 times
-    left_ports.reserve(repetitions * l_size);
-    for (std::size_t i{1}; i < repetitions; i++) {
-      std::copy_n(left_ports.begin(), l_size, std::back_inserter(left_ports));
+/**
+ * Connects a list of left ports to a sequence of right ports.
+ *
+ * The right ports are passed one by one to bind() and are never stored. For iterated connections, the left ports
+ * are reused by wrapping around instead of copying them. The connect function is a template parameter, so that
+ * the compiler can inline it.
+ */
+template <class PortPtr, class Connect> class PortBinder {
+private:
+  const std::vector<PortPtr>& left_ports_;
+  const bool repeat_left_;
+  Connect connect_;
+  std::size_t left_index_{0};
+  std::size_t num_right_ports_{0};
+
+public:
+  PortBinder(const std::vector<PortPtr>& left_ports, bool repeat_left, Connect connect)
+      : left_ports_(left_ports)
+      , repeat_left_(repeat_left)
+      , connect_(std::move(connect)) {}
+
+  void bind(PortPtr right) {
+    num_right_ports_++;
+    if (left_index_ == left_ports_.size()) {
+      if (!repeat_left_ || left_ports_.empty()) {
+        return;
+      }
+      left_index_ = 0;
     }
+    connect_(left_ports_[left_index_], right);
+    left_index_++;
   }
 
-  auto left_it = left_ports.begin();
-  auto right_it = right_ports.begin();
+  void finish() const {
+    auto l_size = left_ports_.size();
+    if (repeat_left_ && l_size != 0) {
+      // the left ports are repeated until all right ports are connected
+      if (num_right_ports_ == 0 || num_right_ports_ % l_size != 0) {
+        reactor::log::Warn() << "There are more left ports than right ports. "
+                             << "Not all ports will be connected!";
+      }
+    } else if (l_size < num_right_ports_) {
+      reactor::log::Warn() << "There are more right ports than left ports. "
+                           << "Not all ports will be connected!";
+    } else if (l_size > num_right_ports_) {
+      reactor::log::Warn() << "There are more left ports than right ports. "
+                           << "Not all ports will be connected!";
+    }
+  }
+};
 
-  if (left_ports.size() < right_ports.size()) {
-    reactor::log::Warn() << "There are more right ports than left ports. "
-                         << "Not all ports will be connected!";
-  } else if (left_ports.size() > right_ports.size()) {
-    reactor::log::Warn() << "There are more left ports than right ports. "
-                         << "Not all ports will be connected!";
+/**
+ * The names of the channels of a multiport or of the members of a bank, e.g. in_0, in_1, ...
+ *
+ * A single instance is shared by all instances of the declaring reactor, so that each name is
+ * formatted once instead of once for every channel or bank member. The runtime still copies the
+ * name into each element and builds its fully qualified name. Reactors of different ROS 2 nodes may
+ * be constructed concurrently within the same process, so the table is guarded by a mutex. The
+ * returned references stay valid while the table grows.
+ */
+class IndexedNames {
+private:
+  const std::string prefix_;
+  // deque, because references to the names must stay valid when growing
+  std::deque<std::string> names_;
+  std::mutex mutex_;
+
+public:
+  explicit IndexedNames(const std::string& base)
+      : prefix_(base + '_') {}
+  IndexedNames(const IndexedNames&) = delete;
+  auto operator=(const IndexedNames&) -> IndexedNames& = delete;
+
+  auto operator[](std::size_t index) -> const std::string& {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (names_.size() <= index) {
+      names_.push_back(prefix_ + std::to_string(names_.size()));
+    }
+    return names_[index];
   }
+};
+
+/**
+ * The indices of the present ports of a bank, maintained incrementally as the ports are set.
+ *
+ * This allows a reaction to only visit the bank members that produced a value, similar to
+ * `present_indices_unsorted()` of multiports. The indices are in the order in which the ports were
+ * set. Ports are registered in the order of the bank members when the reactor is constructed.
+ */
+class PresentIndices {
+private:
+  std::vector<std::size_t> indices_;
+  // deque, because atomics cannot be moved when growing a vector
+  std::deque<std::atomic<bool>> marked_;
+  std::atomic<std::size_t> size_{0};
 
-  while (left_it != left_ports.end() && right_it != right_ports.end()) {
-    auto left = *left_it;
-    auto right = *right_it;
-    connect(left, right);
-    left_it++;
-    right_it++;
+public:
+  PresentIndices() = default;
+  PresentIndices(const PresentIndices&) = delete;
+  auto operator=(const PresentIndices&) -> PresentIndices& = delete;
+
+  void register_port(reactor::BasePort& port) {
+    std::size_t index = marked_.size();
+    marked_.emplace_back(false);
+    indices_.push_back(0);
+    // Ports of different bank members may be set concurrently. Each port claims its own slot.
+    port.register_set_callback([this, index](const reactor::BasePort&) {
+      if (!marked_[index].exchange(true, std::memory_order_relaxed)) {
+        indices_[size_.fetch_add(1, std::memory_order_relaxed)] = index;
+      }
+    });
+    port.register_clean_callback([this, index](const reactor::BasePort&) {
+      marked_[index].store(false, std::memory_order_relaxed);
+      size_.store(0, std::memory_order_relaxed);
+    });
   }
-}
+
+  [[nodiscard]] auto begin() const noexcept { return indices_.cbegin(); }
+  [[nodiscard]] auto end() const noexcept { return indices_.cbegin() + size(); }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_.load(std::memory_order_relaxed); }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+};
 
 } // namespace lfutil
@@ -27,19 +27,199 @@
 #include "reactor-cpp/reactor-cpp.hh"
 #include <sstream>
 
-std::stringstream& operator>>(std::stringstream& in, reactor::Duration& dur);
+inline std::stringstream& operator>>(std::stringstream& in, reactor::Duration& dur);
 #include "CLI/cxxopts.hpp"
 
-#include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <regex>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <utility>
 
-bool iequals(const std::string& a, const std::string& b) {
-  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char a, char b) { return tolower(a) == tolower(b); });
+namespace lfutil::time_parser {
+
+/// A time unit and its length in nanoseconds
+struct Unit {
+  std::string_view name;
+  reactor::Duration::rep nanoseconds;
+};
+
+constexpr reactor::Duration::rep nsec{1};
+constexpr reactor::Duration::rep usec{1000 * nsec};
+constexpr reactor::Duration::rep msec{1000 * usec};
+constexpr reactor::Duration::rep sec{1000 * msec};
+constexpr reactor::Duration::rep minute{60 * sec};
+constexpr reactor::Duration::rep hour{60 * minute};
+constexpr reactor::Duration::rep day{24 * hour};
+constexpr reactor::Duration::rep week{7 * day};
+
+/// All units supported in time strings. The most common spellings come first.
+constexpr std::array<Unit, 28> units{{
+    {"ms", msec},       {"s", sec},         {"us", usec},       {"ns", nsec},       {"msec", msec},
+    {"msecs", msec},    {"sec", sec},       {"secs", sec},      {"second", sec},    {"seconds", sec},
+    {"usec", usec},     {"usecs", usec},    {"nsec", nsec},     {"nsecs", nsec},    {"min", minute},
+    {"mins", minute},   {"minute", minute}, {"minutes", minute}, {"m", minute},     {"hour", hour},
+    {"hours", hour},    {"h", hour},        {"day", day},       {"days", day},      {"d", day},
+    {"week", week},     {"weeks", week},    {"w", week},
+}};
+
+/// Get the length of the given unit in nanoseconds, or 0 if the unit is unknown.
+constexpr auto unit_length(std::string_view name) noexcept -> reactor::Duration::rep {
+  for (const auto& unit : units) {
+    if (unit.name == name) {
+      return unit.nanoseconds;
+    }
+  }
+  return 0;
+}
+
+enum class ParseError {
+  None,
+  Empty,
+  Negative,
+  InvalidNumber,
+  NoUnit,
+  InvalidUnit,
+  OutOfRange,
+};
+
+constexpr auto is_space(char c) noexcept -> bool { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+constexpr auto is_digit(char c) noexcept -> bool { return c >= '0' && c <= '9'; }
+
+constexpr auto trim(std::string_view text) noexcept -> std::string_view {
+  while (!text.empty() && is_space(text.front())) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && is_space(text.back())) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+constexpr auto to_lower(char c) noexcept -> char { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+constexpr auto iequals(std::string_view lhs, std::string_view rhs) noexcept -> bool {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (std::size_t i{0}; i < lhs.size(); i++) {
+    if (to_lower(lhs[i]) != to_lower(rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Split a trimmed time string into the leading number and the unit that follows it.
+constexpr auto split(std::string_view text) noexcept -> std::pair<std::string_view, std::string_view> {
+  std::size_t pos{0};
+  while (pos < text.size() && (is_digit(text[pos]) || text[pos] == '.')) {
+    pos++;
+  }
+  return {text.substr(0, pos), trim(text.substr(pos))};
+}
+
+/**
+ * Parse a time string of the form "<number> <unit>" or "forever".
+ *
+ * The string is parsed in a single pass without allocating memory. The integral part of the number
+ * is converted exactly; a fractional part is scaled with double precision, as in the original
+ * stream based parser. A number that is zero may omit the unit.
+ */
+inline auto parse_duration(std::string_view text, reactor::Duration& dur) noexcept -> ParseError {
+  text = trim(text);
+  if (text.empty()) {
+    return ParseError::Empty;
+  }
+  if (text.front() == '-') {
+    return ParseError::Negative;
+  }
+  if (iequals(text, "forever")) {
+    dur = reactor::Duration::max();
+    return ParseError::None;
+  }
+
+  auto [number, unit] = split(text);
+  const char* pos = number.data();
+  const char* const end = number.data() + number.size();
+
+  std::uint64_t integral{0};
+  if (pos != end && *pos != '.') {
+    auto [ptr, ec] = std::from_chars(pos, end, integral);
+    if (ec == std::errc::result_out_of_range) {
+      return ParseError::OutOfRange;
+    }
+    pos = ptr;
+  }
+  bool has_digits = pos != number.data();
+
+  // digits beyond the 18th fractional digit are below any meaningful resolution and are dropped
+  std::uint64_t fraction{0};
+  std::uint64_t fraction_scale{1};
+  if (pos != end && *pos == '.') {
+    for (pos++; pos != end && is_digit(*pos); pos++) {
+      has_digits = true;
+      if (fraction_scale < 1'000'000'000'000'000'000ull) {
+        fraction = 10 * fraction + static_cast<std::uint64_t>(*pos - '0');
+        fraction_scale *= 10;
+      }
+    }
+  }
+  if (!has_digits || pos != end) {
+    return ParseError::InvalidNumber;
+  }
+
+  if (unit.empty()) {
+    if (integral == 0 && fraction == 0) {
+      dur = reactor::Duration::zero();
+      return ParseError::None;
+    }
+    return ParseError::NoUnit;
+  }
+  auto length = unit_length(unit);
+  if (length == 0) {
+    return ParseError::InvalidUnit;
+  }
+
+  constexpr auto max = std::numeric_limits<reactor::Duration::rep>::max();
+  if (integral > static_cast<std::uint64_t>(max / length)) {
+    return ParseError::OutOfRange;
+  }
+  auto whole = static_cast<reactor::Duration::rep>(integral) * length;
+  auto partial = static_cast<reactor::Duration::rep>(static_cast<double>(fraction) /
+                                                     static_cast<double>(fraction_scale) * static_cast<double>(length));
+  if (whole > max - partial) {
+    return ParseError::OutOfRange;
+  }
+  dur = reactor::Duration{whole + partial};
+  return ParseError::None;
+}
+
+/// Describe why the given time string could not be parsed.
+inline auto describe(ParseError error, std::string_view text) -> std::string {
+  switch (error) {
+  case ParseError::None:
+    return "";
+  case ParseError::Empty:
+    return "The empty string is not a valid time!";
+  case ParseError::Negative:
+    return "Negative values are not a valid time!";
+  case ParseError::InvalidNumber:
+    return "Not a valid number!";
+  case ParseError::NoUnit:
+    return "No unit given!";
+  case ParseError::InvalidUnit:
+    return "Not a valid unit: " + std::string{split(trim(text)).second};
+  case ParseError::OutOfRange:
+    return "The time value is out of range!";
+  }
+  return "Unexpected error!";
 }
 
+} // namespace lfutil::time_parser
+
 class argument_incorrect_type_with_reason : public cxxopts::OptionParseException {
 public:
   explicit argument_incorrect_type_with_reason(const std::string& arg, const std::string& reason)
@@ -47,19 +227,14 @@ public:
                                       reason + ")") {}
 };
 
-std::string validate_time_string(const std::string& time);
-
 /**
  * converts a reactor::Duration to a string with ns as unit
  */
-std::string time_to_string(const reactor::Duration& dur) {
+inline std::string time_to_string(const reactor::Duration& dur) {
   if (dur == reactor::Duration::max()) {
     return "forever";
   }
-
-  std::stringstream ss;
-  ss << dur.count() << " ns";
-  return ss.str();
+  return std::to_string(dur.count()) + " ns";
 }
 
 template <typename T> std::string any_to_string(const T val) {
@@ -68,97 +243,25 @@ template <typename T> std::string any_to_string(const T val) {
   return ss.str();
 }
 
-std::stringstream& operator>>(std::stringstream& in, reactor::Duration& dur) {
-  double value;
-  std::string unit;
-
-  const std::string validation_msg = validate_time_string(in.str());
-  if (!validation_msg.empty()) {
+/**
+ * Parses a time string as it is passed by cxxopts.
+ *
+ * cxxopts creates the stream from the argument, so the stream content is the entire argument.
+ */
+inline std::stringstream& operator>>(std::stringstream& in, reactor::Duration& dur) {
+  const std::string text = in.str();
+  auto error = lfutil::time_parser::parse_duration(text, dur);
+  if (error != lfutil::time_parser::ParseError::None) {
     // throw cxxopts error
-    throw argument_incorrect_type_with_reason(in.str(), validation_msg);
-  }
-
-  if (iequals(in.str(), "forever")) {
-    in >> unit; // parse the entire string
-    dur = reactor::Duration::max();
-    return in;
-  }
-
-  // try to read as double
-  in >> value;
-
-  if (value == 0.0) {
-    dur = reactor::Duration::zero();
-    if (!in.eof()) {
-      // parse whatever remains
-      in >> unit;
-    }
-  } else {
-    in >> unit;
-    if (unit == "nsec" || unit == "nsecs" || unit == "ns") {
-      std::chrono::duration<double, std::nano> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "usec" || unit == "usecs" || unit == "us") {
-      std::chrono::duration<double, std::micro> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "msec" || unit == "msecs" || unit == "ms") {
-      std::chrono::duration<double, std::milli> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "sec" || unit == "secs" || unit == "second" || unit == "seconds" || unit == "s") {
-      std::chrono::duration<double, std::ratio<1, 1>> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "min" || unit == "mins" || unit == "minute" || unit == "minutes" || unit == "m") {
-      std::chrono::duration<double, std::ratio<60, 1>> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "hour" || unit == "hours" || unit == "h") {
-      std::chrono::duration<double, std::ratio<3600, 1>> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "day" || unit == "days" || unit == "d") {
-      std::chrono::duration<double, std::ratio<24 * 3600, 1>> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else if (unit == "week" || unit == "weeks" || unit == "w") {
-      std::chrono::duration<double, std::ratio<7 * 24 * 3600, 1>> tmp{value};
-      dur = std::chrono::duration_cast<reactor::Duration>(tmp);
-    } else {
-      // mark as error
-      in.setstate(std::ifstream::failbit);
-    }
+    throw argument_incorrect_type_with_reason(text, lfutil::time_parser::describe(error, text));
   }
-
   return in;
 }
 
 /**
  *   Tests for correct syntax in unit usage for time strings
  **/
-std::string validate_time_string(const std::string& time) {
-  auto trimmed = std::regex_replace(time, std::regex("^ +| +$|( ) +"), "$1");
-  if (trimmed.size() == 0) {
-    return "The empty string is not a valid time!";
-  } else if (trimmed[0] == '-') {
-    return "Negative values are not a valid time!";
-  } else if (iequals("forever", time)) {
-    return ""; // "forever" is a valid value
-  } else if (trimmed.find_first_not_of("0.") == std::string::npos) {
-    return "";
-  } else {
-    auto pos = trimmed.find_first_not_of("0123456789. \n\r\t");
-    if (pos == std::string::npos) {
-      return "No unit given!";
-    } else {
-      auto unit = trimmed.substr(pos);
-      if (unit == "nsec" || unit == "nsecs" || unit == "ns" || unit == "usec" || unit == "usecs" || unit == "us" ||
-          unit == "msec" || unit == "msecs" || unit == "ms" || unit == "sec" || unit == "secs" || unit == "second" ||
-          unit == "seconds" || unit == "s" || unit == "min" || unit == "mins" || unit == "minute" ||
-          unit == "minutes" || unit == "m" || unit == "hour" || unit == "hours" || unit == "h" || unit == "day" ||
-          unit == "days" || unit == "d" || unit == "week" || unit == "weeks" || unit == "w") {
-        return "";
-      } else {
-        std::stringstream ss;
-        ss << "Not a valid unit: " << unit;
-        return ss.str();
-      }
-    }
-  }
-  return "Unexpected error!";
+inline std::string validate_time_string(const std::string& time) {
+  reactor::Duration dur{};
+  return lfutil::time_parser::describe(lfutil::time_parser::parse_duration(time, dur), time);
 }
@@ -29,6 +29,7 @@ package org.lflang.tests.compiler;
 import static org.lflang.ast.ASTUtils.*;
 
 import com.google.inject.Inject;
+import java.time.Duration;
 import org.eclipse.emf.common.util.TreeIterator;
 import org.eclipse.emf.ecore.EObject;
 import org.eclipse.xtext.testing.InjectWith;
@@ -39,6 +40,7 @@ import org.junit.jupiter.api.Test;
 import org.junit.jupiter.api.extension.ExtendWith;
 import org.lflang.DefaultMessageReporter;
 import org.lflang.ModelInfo;
+import org.lflang.generator.ReactionInstanceGraph;
 import org.lflang.generator.ReactorInstance;
 import org.lflang.lf.Instantiation;
 import org.lflang.lf.LfFactory;
@@ -148,6 +150,50 @@ class LinguaFrancaDependencyAnalysisTest {
     Assertions.assertFalse(instance.getCycles().isEmpty());
   }
 
+  /** Check that levels are assigned to wide banks in time that grows linearly with the width. */
+  @Test
+  public void wideBankLevels() throws Exception {
+    String testCase =
+        """
+             target C;
+
+             reactor Source {
+                 output out: int;
+                 reaction(startup) -> out {=
+                 //
+                 =}
+             }
+
+             reactor Sink {
+                 input in: int;
+                 reaction(in) {=
+                 //
+                 =}
+             }
+
+             main reactor {
+                 a = new[20000] Source();
+                 b = new[20000] Sink();
+                 a.out -> b.in;
+             }
+         """;
+    Model model = parser.parse(testCase);
+    Assertions.assertNotNull(model);
+    Reactor main =
+        model.getReactors().stream().filter(Reactor::isMain).findFirst().orElseThrow();
+
+    Assertions.assertTimeoutPreemptively(
+        Duration.ofSeconds(60),
+        () -> {
+          ReactorInstance instance = new ReactorInstance(main, new DefaultMessageReporter());
+          ReactionInstanceGraph graph = instance.assignLevels();
+          Assertions.assertEquals(0, graph.nodeCount());
+          var sinks = instance.children.get(1).reactions.get(0).getRuntimeInstances();
+          Assertions.assertEquals(20000, sinks.size());
+          Assertions.assertTrue(sinks.stream().allMatch(it -> it.level == 1));
+        });
+  }
+
   /** Check that circular instantiations are detected. */
   @Test
   public void circularInstantiation() throws Exception {
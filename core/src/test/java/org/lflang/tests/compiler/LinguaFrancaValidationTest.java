@@ -1902,6 +1902,44 @@ public class LinguaFrancaValidationTest {
             + "In C++, any value can be made mutable by calling get_mutable_copy().");
   }
 
+  @Test
+  public void testSoaRequiresBank() throws Exception {
+    String testCase =
+        """
+                target Cpp;
+                reactor A {
+                    state x:int = 0;
+                }
+                main reactor {
+                    @soa
+                    a = new A();
+                }
+            """;
+    validator.assertError(
+        parseWithoutError(testCase),
+        LfPackage.eINSTANCE.getInstantiation(),
+        null,
+        "The @soa attribute can only be applied to banks.");
+  }
+
+  @Test
+  public void testInvalidEnclaveCpus() throws Exception {
+    String testCase =
+        """
+                target Cpp;
+                reactor A {}
+                main reactor {
+                    @enclave(cpus="3-1")
+                    a = new A();
+                }
+            """;
+    validator.assertError(
+        parseWithoutError(testCase),
+        LfPackage.eINSTANCE.getInstantiation(),
+        null,
+        "Expected a comma separated list of CPU numbers and ranges, e.g. \"0-3,8\".");
+  }
+
   @Test
   public void testOverflowingSTP() throws Exception {
     String testCase =
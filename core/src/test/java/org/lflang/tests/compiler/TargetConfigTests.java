@@ -4,6 +4,8 @@ import com.google.inject.Inject;
 import com.google.inject.Provider;
 import java.nio.file.Files;
 import java.nio.file.Path;
+import java.util.regex.Pattern;
+import java.util.stream.Collectors;
 import org.eclipse.emf.common.util.URI;
 import org.eclipse.emf.ecore.resource.ResourceSet;
 import org.eclipse.xtext.generator.JavaIoFileSystemAccess;
@@ -20,7 +22,9 @@ import org.lflang.generator.LFGenerator;
 import org.lflang.generator.LFGeneratorContext.Mode;
 import org.lflang.generator.MainContext;
 import org.lflang.lf.Model;
+import org.lflang.target.property.CpusProperty;
 import org.lflang.tests.LFInjectorProvider;
+import org.lflang.tests.TestRegistry;
 
 @ExtendWith(InjectionExtension.class)
 @InjectWith(LFInjectorProvider.class)
@@ -105,4 +109,32 @@ class TargetConfigTests {
     Model federate = parser.parse(lfSrc);
     assertHasTargetProperty(federate, "tracing");
   }
+
+  /**
+   * Check that the validator of the cpus target property accepts the same CPU lists as the C++
+   * runtime. The cases are shared with the C++ test that checks the parser of the runtime.
+   *
+   * @throws Exception
+   */
+  @Test
+  public void testCpuListsMatchRuntime() throws Exception {
+    var test = TestRegistry.LF_TEST_PATH.resolve("Cpp/src/target/CpuList.lf");
+    var matcher =
+        Pattern.compile("\\{\"([^\"]*)\", (?:\"([^\"]*)\"|nullptr)\\},")
+            .matcher(Files.readString(test));
+    int cases = 0;
+    while (matcher.find()) {
+      var list = matcher.group(1).replace("\\t", "\t");
+      var actual = CpusProperty.parseCpuList(list);
+      if (matcher.group(2) == null) {
+        Assertions.assertNull(actual, "Accepted malformed CPU list \"" + list + "\"");
+      } else {
+        Assertions.assertNotNull(actual, "Rejected CPU list \"" + list + "\"");
+        var expected = actual.stream().map(String::valueOf).collect(Collectors.joining(","));
+        Assertions.assertEquals(matcher.group(2), expected, "CPU list \"" + list + "\"");
+      }
+      cases++;
+    }
+    Assertions.assertTrue(cases > 0, "Found no CPU lists in " + test);
+  }
 }
@@ -129,6 +129,8 @@ public abstract class TestBase extends LfInjectedTestBase {
     public static final String NO_FEDERATION_SUPPORT =
         "Target does not support federated execution.";
     public static final String NO_ENCLAVE_SUPPORT = "Targeet does not support the enclave feature.";
+    public static final String NO_BENCHMARK_SUPPORT =
+        "Target does not support the 'benchmark' property.";
     public static final String NO_DOCKER_SUPPORT = "Target does not support the 'docker' property.";
     public static final String NO_DOCKER_TEST_SUPPORT = "Docker tests are only supported on Linux.";
 
@@ -142,6 +144,7 @@ public abstract class TestBase extends LfInjectedTestBase {
     public static final String DESC_DOCKER = "Run docker tests.";
     public static final String DESC_DOCKER_FEDERATED = "Run docker federated tests.";
     public static final String DESC_ENCLAVE = "Run enclave tests.";
+    public static final String DESC_BENCHMARK = "Run benchmark tests.";
     public static final String DESC_CONCURRENT = "Run concurrent tests.";
     public static final String DESC_TARGET_SPECIFIC = "Run target-specific tests";
     public static final String DESC_ARDUINO = "Running Arduino tests.";
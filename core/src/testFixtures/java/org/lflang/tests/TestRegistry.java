@@ -314,6 +314,8 @@ public class TestRegistry {
     CONCURRENT(true, "", TestLevel.EXECUTION),
     /** Test about enclaves */
     ENCLAVE(false, "", TestLevel.EXECUTION),
+    /** Benchmark programs that are also compiled into a benchmark executable */
+    BENCHMARK(false, "", TestLevel.EXECUTION),
     /** Basic tests, ie, tests that all targets are supposed to implement. */
     BASIC(true, "", TestLevel.EXECUTION),
     /** Tests about generics */